@@ -5,4 +5,76 @@
 
 #include "common.h"
 
+void goldbach_pthread_get_unit(const goldbach_pthread_t* goldbach_pthread,
+  int64_t position, goldbach_number_t* goldbach_number) {
+  const int64_t unit = goldbach_pthread->unit_order
+    ? goldbach_pthread->unit_order[position] : position;
+  // Find the last number whose first unit is not after the unit
+  int64_t first = 0;
+  int64_t last = array_int64_getCount(goldbach_pthread->numbers);
+  while (last - first > 1) {
+    const int64_t middle = first + (last - first) / 2;
+    if (goldbach_pthread->splits[middle].first_unit <= unit) {
+      first = middle;
+    } else {
+      last = middle;
+    }
+  }
 
+  const goldbach_split_t* split = &goldbach_pthread->splits[first];
+  goldbach_number->number = array_int64_getElement(goldbach_pthread->numbers,
+    first);
+  goldbach_number->index = first;
+  goldbach_number->position = position;
+  goldbach_number->batch_count = 0;
+  goldbach_split_range(llabs(goldbach_number->number), unit - split->first_unit,
+    split->part_count, &goldbach_number->start, &goldbach_number->finish);
+}
+
+int64_t goldbach_pthread_get_window_end(
+  const goldbach_pthread_t* goldbach_pthread, int64_t position) {
+  goldbach_number_t goldbach_number;
+  goldbach_pthread_get_unit(goldbach_pthread, position, &goldbach_number);
+  const int64_t window = goldbach_pthread->options.window;
+  const int64_t next_index = (goldbach_number.index / window + 1) * window;
+  if (next_index >= array_int64_getCount(goldbach_pthread->numbers)) {
+    return goldbach_pthread->unit_count;
+  }
+  return goldbach_pthread->splits[next_index].first_unit;
+}
+
+void goldbach_pthread_bind(const private_data_t* private_data) {
+  const goldbach_pthread_t* goldbach_pthread = private_data->goldbach_pthread;
+  if (goldbach_pthread->topology.placement_count > 0) {
+    // A thread that cannot be pinned still calculates on any processor
+    cpu_topology_bind(&goldbach_pthread->topology,
+      private_data->thread_number < goldbach_pthread->consumer_count
+      ? private_data->thread_number : -1);
+  }
+}
+
+goldbach_split_t* goldbach_pthread_get_split(
+  const goldbach_pthread_t* goldbach_pthread, int64_t index) {
+  if (goldbach_pthread->stream) {
+    return &goldbach_stream_get(goldbach_pthread->stream, index)->split;
+  }
+  return &goldbach_pthread->splits[index];
+}
+
+goldbach_sums_array_t* goldbach_pthread_get_sums(
+  const goldbach_pthread_t* goldbach_pthread, int64_t index) {
+  if (goldbach_pthread->stream) {
+    return &goldbach_stream_get(goldbach_pthread->stream, index)->sums;
+  }
+  return goldbach_pthread->goldbach_sums[index];
+}
+
+void goldbach_pthread_wake_thieves(goldbach_pthread_t* goldbach_pthread) {
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&goldbach_pthread->sleeping_count,
+    memory_order_relaxed) > 0) {
+    pthread_mutex_lock(&goldbach_pthread->can_access_sleeping);
+    pthread_cond_broadcast(&goldbach_pthread->has_tasks);
+    pthread_mutex_unlock(&goldbach_pthread->can_access_sleeping);
+  }
+}
@@ -11,28 +11,152 @@
 #include <unistd.h>
 
 #include "array_int64.h"
+#include "cpu_topology.h"
+#include "goldbach_arena.h"
+#include "goldbach_claim.h"
+#include "goldbach_cost.h"
+#include "goldbach_deque.h"
 #include "goldbach_sums_array.h"
 #include "goldbach_number_queue.h"
+#include "goldbach_options.h"
+#include "goldbach_output.h"
+#include "goldbach_pair_table.h"
+#include "goldbach_reorder_buffer.h"
+#include "goldbach_split.h"
+#include "goldbach_stream.h"
+#include "prime_sieve.h"
+#include "thread_pool.h"
 
 // Shared data
 typedef struct goldbach_pthread {
+  goldbach_options_t options;
   array_int64_t* numbers;
   int64_t unit_count;
   goldbach_number_queue_t queue;
   // thread_count
   int64_t consumer_count;
-  sem_t can_consume;
   sem_t can_access_next_unit;
   int64_t next_unit;
-  sem_t can_access_consumed_count;
-  int64_t consumed_count;
+  /// Next unit that no consumer has claimed, used by the cursor schedule
+  atomic_int_fast64_t cursor;
+  /// Units handed out at once by the cursor and the queue schedules
+  goldbach_claim_t claim;
+  /// Deque of tasks of every consumer, used by the steal schedule
+  goldbach_deque_t* deques;
+  /// Tasks that are not finished, including the ones being calculated
+  atomic_int_fast64_t pending_task_count;
+  /// Consumers that did not find a task to steal
+  atomic_int_fast64_t idle_count;
+  /// Idle consumers sleeping until a task is pushed or every task finishes
+  atomic_int sleeping_count;
+  pthread_mutex_t can_access_sleeping;
+  pthread_cond_t has_tasks;
+  /// Windows of positions dealt to the deques, -1 after the last one
+  int64_t dealt_window_count;
+  /// Consumers that finished the tasks of the last window dealt
+  int64_t waiting_count;
+  pthread_mutex_t can_access_windows;
+  pthread_cond_t has_window;
+  pthread_cond_t is_window_finished;
   goldbach_sums_array_t** goldbach_sums;
+  /// A unit could not store its sums, so the results are not printed
+  atomic_bool has_failed;
+  /// Parts of every number, big numbers are calculated by several threads
+  goldbach_split_t* splits;
+  /// Numbers of the input when they are calculated while being read, NULL
+  /// when the input is calculated as one batch
+  goldbach_stream_t* stream;
+  /// Finished numbers that the writer prints in the order of the input
+  goldbach_reorder_buffer_t* reorder_buffer;
+  /// Units in the order they are handed out, NULL for the input order
+  int64_t* unit_order;
+  /// Nanoseconds spent in every number, NULL if they are not reported
+  atomic_int_fast64_t* elapsed_times;
+  /// Shared by every batch, grows when bigger numbers arrive
+  prime_sieve_t sieve;
+  goldbach_pair_table_t pair_table;
+  /// Consumers that calculate every batch, created once
+  thread_pool_t pool;
+  /// Chunks of the sums appended by every consumer, kept between batches
+  goldbach_arena_t* arenas;
+  /// Text of the results, written to stdout by the writer
+  goldbach_output_t output;
+  /// Processors where the consumers are pinned, empty without affinity
+  cpu_topology_t topology;
+  /// Data of every consumer and, at the end, of the producer
+  struct private_data* private_data;
 } goldbach_pthread_t;
 
-typedef struct  {
+typedef struct private_data {
   goldbach_number_t goldbach_number;
   int64_t thread_number;
   goldbach_pthread_t* goldbach_pthread;
 } private_data_t;
 
+/**
+ * @brief returns the unit handed out at a position of the schedule.
+ * @details maps the position to a unit with the unit order, and finds the
+ * number of the unit with a binary search among the first units of the
+ * numbers.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param position position of the schedule, from 0 to unit_count - 1.
+ * @param goldbach_number where the number and the range of the unit are
+ * stored.
+ */
+void goldbach_pthread_get_unit(const goldbach_pthread_t* goldbach_pthread,
+  int64_t position, goldbach_number_t* goldbach_number);
+
+/**
+ * @brief returns the first position after the window of a position.
+ * @details the numbers of the batch are grouped in windows of as many
+ * numbers as the window of the options, and the units of a window take
+ * consecutive positions of the schedule, after the units of the windows
+ * before it.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param position position of the schedule, from 0 to unit_count - 1.
+ * @return the first position of the next window, or unit_count.
+ */
+int64_t goldbach_pthread_get_window_end(
+  const goldbach_pthread_t* goldbach_pthread, int64_t position);
+
+/**
+ * @brief pins the calling worker to the processor of its consumer.
+ * @details a worker of the pool runs a different task in every batch, so
+ * every task pins its worker when it starts. Consumers are pinned to the
+ * processor of their thread number in the placement order, and the other
+ * tasks may run on any allowed processor. Memory that a pinned consumer
+ * touches first, like the sums of its parts and the segments it sieves, is
+ * allocated by Linux in the NUMA node of its processor.
+ * @param private_data data of the task.
+ */
+void goldbach_pthread_bind(const private_data_t* private_data);
+
+/**
+ * @brief returns the parts of a number of the batch or of the stream.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param index index of the number.
+ * @return the split of the number.
+ */
+goldbach_split_t* goldbach_pthread_get_split(
+  const goldbach_pthread_t* goldbach_pthread, int64_t index);
+
+/**
+ * @brief returns the array of sums of a number of the batch or of the stream.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param index index of the number.
+ * @return the array of sums of the number.
+ */
+goldbach_sums_array_t* goldbach_pthread_get_sums(
+  const goldbach_pthread_t* goldbach_pthread, int64_t index);
+
+/**
+ * @brief wakes the consumers sleeping for a task to steal up.
+ * @details called after a task is pushed to a deque and after the last task
+ * finishes. The fence orders them before the load of the sleeping count, and
+ * a sleeping consumer tries to steal again after increasing it, so a wake up
+ * is never lost.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ */
+void goldbach_pthread_wake_thieves(goldbach_pthread_t* goldbach_pthread);
+
 #endif  // COMMON_H
@@ -2,28 +2,236 @@
 // Simulates a producer and a consumer that share a unbounded buffer
 // Consumes a goldbach_number struct
 
+#include <sched.h>
+
 #include "consumer.h"
 
+/**
+ * @brief waits until the next window is dealt to the deques.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param window_count windows that the consumer finished, updated to the
+ * windows dealt.
+ * @return true if a window was dealt, false if every window was finished.
+ */
+bool consume_wait_window(goldbach_pthread_t* goldbach_pthread,
+  int64_t* window_count);
+
+/**
+ * @brief consumes the tasks of a window until every one is finished.
+ * @param private_data data of the consumer.
+ */
+void consume_steal_window(private_data_t* private_data);
+
+/**
+ * @brief steals a task from the deque of other consumer.
+ * @details tries the other consumers in a round starting at the next one.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param thread_number number of the thief.
+ * @return the task, or NULL if every other deque was empty.
+ */
+goldbach_number_t* consume_steal_task(goldbach_pthread_t* goldbach_pthread,
+  int64_t thread_number);
+
+/**
+ * @brief sleeps until a task can be stolen or every task is finished.
+ * @details the consumer is counted as sleeping before it tries to steal
+ * again, so a task pushed meanwhile always wakes it up.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param thread_number number of the thief.
+ * @return the task, or NULL if every task is finished.
+ */
+goldbach_number_t* consume_wait_task(goldbach_pthread_t* goldbach_pthread,
+  int64_t thread_number);
+
 void* consume(void* data) {
   private_data_t* private_data = (private_data_t*)data;
+  goldbach_pthread_bind(private_data);
   goldbach_pthread_t* goldbach_pthread = private_data->goldbach_pthread;
 
   while (true) {
-    sem_wait(&goldbach_pthread->can_access_consumed_count);
-    if (goldbach_pthread->consumed_count > goldbach_pthread->unit_count) {
-      sem_post(&goldbach_pthread->can_access_consumed_count);
-      break;
-    }
-    ++goldbach_pthread->consumed_count;
-    sem_post(&goldbach_pthread->can_access_consumed_count);
-
-    sem_wait(&goldbach_pthread->can_consume);
-
     // Consume
     goldbach_number_queue_dequeue(&goldbach_pthread->queue,
       &private_data->goldbach_number);
+    // A unit without number tells that there are no more units
+    if (private_data->goldbach_number.index < 0) {
+      break;
+    }
+    const int64_t position = private_data->goldbach_number.position;
+    const int64_t batch_count = private_data->goldbach_number.batch_count;
+    const bool is_measured = goldbach_pthread->stream == NULL
+      && goldbach_pthread->claim.fixed_size == 0;
+    struct timespec start_time;
+    if (is_measured) {
+      clock_gettime(CLOCK_MONOTONIC, &start_time);
+    }
     goldbach_calculator_calculate_goldbach(private_data);
+    // The other units of the batch follow the first one in the schedule
+    for (int64_t offset = 1; offset <= batch_count; ++offset) {
+      goldbach_pthread_get_unit(goldbach_pthread, position + offset,
+        &private_data->goldbach_number);
+      goldbach_calculator_calculate_goldbach(private_data);
+    }
+    if (is_measured) {
+      goldbach_claim_record(&goldbach_pthread->claim, batch_count + 1,
+        &start_time);
+    }
+  }
+
+  return NULL;
+}
+
+void* consume_cursor(void* data) {
+  private_data_t* private_data = (private_data_t*)data;
+  goldbach_pthread_bind(private_data);
+  goldbach_pthread_t* goldbach_pthread = private_data->goldbach_pthread;
+  const int64_t unit_count = goldbach_pthread->unit_count;
+  goldbach_claim_t* claim = &goldbach_pthread->claim;
+  goldbach_number_t* goldbach_number = &private_data->goldbach_number;
+
+  while (true) {
+    // Claim a chunk of consecutive positions of the schedule
+    const int64_t chunk_size = goldbach_claim_size(claim, unit_count
+      - atomic_load_explicit(&goldbach_pthread->cursor, memory_order_relaxed),
+      goldbach_pthread->consumer_count);
+    const int64_t first = atomic_fetch_add_explicit(&goldbach_pthread->cursor,
+      chunk_size, memory_order_relaxed);
+    if (first >= unit_count) {
+      break;
+    }
+    int64_t last = first + chunk_size;
+    if (last > unit_count) {
+      last = unit_count;
+    }
+
+    struct timespec start_time;
+    if (claim->fixed_size == 0) {
+      clock_gettime(CLOCK_MONOTONIC, &start_time);
+    }
+    for (int64_t position = first; position < last; ++position) {
+      goldbach_pthread_get_unit(goldbach_pthread, position, goldbach_number);
+      goldbach_reorder_buffer_reserve(goldbach_pthread->reorder_buffer,
+        goldbach_number->index);
+      goldbach_calculator_calculate_goldbach(private_data);
+    }
+    if (claim->fixed_size == 0) {
+      goldbach_claim_record(claim, last - first, &start_time);
+    }
   }
 
   return NULL;
 }
+
+void* consume_steal(void* data) {
+  private_data_t* private_data = (private_data_t*)data;
+  goldbach_pthread_bind(private_data);
+  int64_t window_count = 0;
+
+  while (consume_wait_window(private_data->goldbach_pthread, &window_count)) {
+    consume_steal_window(private_data);
+  }
+  return NULL;
+}
+
+bool consume_wait_window(goldbach_pthread_t* goldbach_pthread,
+  int64_t* window_count) {
+  pthread_mutex_lock(&goldbach_pthread->can_access_windows);
+  ++goldbach_pthread->waiting_count;
+  pthread_cond_signal(&goldbach_pthread->is_window_finished);
+  while (goldbach_pthread->dealt_window_count == *window_count) {
+    pthread_cond_wait(&goldbach_pthread->has_window,
+      &goldbach_pthread->can_access_windows);
+  }
+  *window_count = goldbach_pthread->dealt_window_count;
+  pthread_mutex_unlock(&goldbach_pthread->can_access_windows);
+  return *window_count >= 0;
+}
+
+void consume_steal_window(private_data_t* private_data) {
+  goldbach_pthread_t* goldbach_pthread = private_data->goldbach_pthread;
+  goldbach_deque_t* deque =
+    &goldbach_pthread->deques[private_data->thread_number];
+  bool is_idle = false;
+  int64_t failed_rounds = 0;
+
+  while (true) {
+    goldbach_number_t* task = goldbach_deque_take(deque);
+    if (task == NULL) {
+      task = consume_steal_task(goldbach_pthread,
+        private_data->thread_number);
+    }
+    if (task == NULL && failed_rounds >= CONSUMER_STEAL_SPIN_COUNT) {
+      task = consume_wait_task(goldbach_pthread, private_data->thread_number);
+      if (task == NULL) {
+        break;
+      }
+    }
+
+    if (task) {
+      if (is_idle) {
+        atomic_fetch_sub(&goldbach_pthread->idle_count, 1);
+        is_idle = false;
+      }
+      failed_rounds = 0;
+      private_data->goldbach_number = *task;
+      free(task);
+      // The windows before are calculated, so the writer frees a place soon
+      goldbach_reorder_buffer_reserve(goldbach_pthread->reorder_buffer,
+        private_data->goldbach_number.index);
+      goldbach_calculator_calculate_goldbach(private_data);
+      // The sleeping consumers stop after the last task
+      if (atomic_fetch_sub(&goldbach_pthread->pending_task_count, 1) == 1) {
+        goldbach_pthread_wake_thieves(goldbach_pthread);
+      }
+    } else {
+      // Tasks being calculated can still be cut for this consumer
+      if (atomic_load(&goldbach_pthread->pending_task_count) == 0) {
+        break;
+      }
+      if (!is_idle) {
+        atomic_fetch_add(&goldbach_pthread->idle_count, 1);
+        is_idle = true;
+      }
+      ++failed_rounds;
+      sched_yield();
+    }
+  }
+
+  if (is_idle) {
+    atomic_fetch_sub(&goldbach_pthread->idle_count, 1);
+  }
+}
+
+goldbach_number_t* consume_steal_task(goldbach_pthread_t* goldbach_pthread,
+  int64_t thread_number) {
+  const int64_t consumer_count = goldbach_pthread->consumer_count;
+  for (int64_t offset = 1; offset < consumer_count; ++offset) {
+    goldbach_deque_t* victim = &goldbach_pthread->deques[
+      (thread_number + offset) % consumer_count];
+    goldbach_number_t* task = NULL;
+    // Other thief took the top first, try the next top
+    while (!goldbach_deque_steal(victim, &task)) {
+    }
+    if (task) {
+      return task;
+    }
+  }
+  return NULL;
+}
+
+goldbach_number_t* consume_wait_task(goldbach_pthread_t* goldbach_pthread,
+  int64_t thread_number) {
+  pthread_mutex_lock(&goldbach_pthread->can_access_sleeping);
+  atomic_fetch_add(&goldbach_pthread->sleeping_count, 1);
+  atomic_thread_fence(memory_order_seq_cst);
+  goldbach_number_t* task = consume_steal_task(goldbach_pthread,
+    thread_number);
+  while (task == NULL
+    && atomic_load(&goldbach_pthread->pending_task_count) > 0) {
+    pthread_cond_wait(&goldbach_pthread->has_tasks,
+      &goldbach_pthread->can_access_sleeping);
+    task = consume_steal_task(goldbach_pthread, thread_number);
+  }
+  atomic_fetch_sub(&goldbach_pthread->sleeping_count, 1);
+  pthread_mutex_unlock(&goldbach_pthread->can_access_sleeping);
+  return task;
+}
@@ -9,6 +9,45 @@
 #include "goldbach_calculator.h"
 #include "common.h"
 
+/// Failed rounds of steals before an idle consumer sleeps
+#define CONSUMER_STEAL_SPIN_COUNT 64
+
+/**
+ * @brief consumes the units of the queue until it dequeues a stop unit.
+ * @details a unit of the queue can bring the units at the next positions of
+ * the schedule, and the time of the batch tunes the size of the next ones.
+ * @param data private_data of the consumer.
+ * @return null.
+ */
 void* consume(void* data);
 
+/**
+ * @brief consumes units claimed with the shared cursor.
+ * @details every consumer claims chunks of consecutive units with an atomic
+ * fetch-add on the cursor until every unit is claimed, so no producer is
+ * needed and the chunks still balance the load dynamically. Without a fixed
+ * chunk size, chunks of small units are bigger. Waits while the
+ * number of a unit is out of the window of the reorder buffer.
+ * @param data private_data of the consumer.
+ * @return null.
+ */
+void* consume_cursor(void* data);
+
+/**
+ * @brief consumes the tasks of the deque of the consumer and steals others.
+ * @details takes tasks from the bottom of its own deque. When it is empty,
+ * steals from the top of the deques of the other consumers, and while there
+ * is nothing to steal the consumer counts as idle, so the consumers that
+ * calculate big parts cut them for it. After CONSUMER_STEAL_SPIN_COUNT
+ * failed rounds it sleeps until a task is pushed or every task is finished,
+ * instead of spinning for the rest of the batch. The tasks are dealt one
+ * window of numbers at a time, and the consumer waits for the next window
+ * when every task of the last one is finished. Waits while the number of a
+ * task is out of the window of the reorder buffer. Stops after the last
+ * window.
+ * @param data private_data of the consumer.
+ * @return null.
+ */
+void* consume_steal(void* data);
+
 #endif  // CONSUMER_H
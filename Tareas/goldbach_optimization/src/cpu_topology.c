@@ -0,0 +1,244 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+// cpu_set_t and pthread_setaffinity_np() are GNU extensions
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cpu_topology.h"
+
+/**
+ * @brief reads an integer of the topology of a processor in sysfs.
+ * @param cpu number of the processor.
+ * @param name path of the file, relative to the directory of the processor.
+ * @param fallback value returned if the file cannot be read.
+ * @return the integer in the file, or the fallback.
+ */
+int cpu_topology_read(int cpu, const char* name, int fallback);
+
+/**
+ * @brief finds the NUMA node of a processor.
+ * @details sysfs has a link named nodeN in the directory of the processor.
+ * @param cpu number of the processor.
+ * @return the node, or 0 if the processor has no node link.
+ */
+int cpu_topology_read_node(int cpu);
+
+/**
+ * @brief compares two processors by node, package, core and sibling.
+ * @param first pointer to the first cpu_topology_cpu_t.
+ * @param second pointer to the second cpu_topology_cpu_t.
+ * @return a negative number if first goes before second, positive otherwise.
+ */
+int cpu_topology_compare_compact(const void* first, const void* second);
+
+/**
+ * @brief compares two processors by sibling, core rank, node and package.
+ * @param first pointer to the first cpu_topology_cpu_t.
+ * @param second pointer to the second cpu_topology_cpu_t.
+ * @return a negative number if first goes before second, positive otherwise.
+ */
+int cpu_topology_compare_scatter(const void* first, const void* second);
+
+int cpu_topology_init(cpu_topology_t* topology) {
+  assert(topology);
+  topology->cpu_count = 0;
+  topology->cpus = NULL;
+  topology->placement_count = 0;
+
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return EXIT_FAILURE;
+  }
+  topology->cpus = (cpu_topology_cpu_t*) calloc((size_t)CPU_COUNT(&allowed),
+    sizeof(cpu_topology_cpu_t));
+  if (topology->cpus == NULL) {
+    return EXIT_FAILURE;
+  }
+
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed)) {
+      cpu_topology_cpu_t* entry = &topology->cpus[topology->cpu_count++];
+      entry->cpu = cpu;
+      entry->package = cpu_topology_read(cpu,
+        "topology/physical_package_id", 0);
+      entry->core = cpu_topology_read(cpu, "topology/core_id", cpu);
+      entry->node = cpu_topology_read_node(cpu);
+    }
+  }
+  topology->placement_count = topology->cpu_count;
+
+  // Siblings of a core and cores of a node are consecutive in this order
+  qsort(topology->cpus, (size_t)topology->cpu_count,
+    sizeof(cpu_topology_cpu_t), cpu_topology_compare_compact);
+  for (int64_t index = 0; index < topology->cpu_count; ++index) {
+    cpu_topology_cpu_t* entry = &topology->cpus[index];
+    const cpu_topology_cpu_t* previous = index > 0
+      ? &topology->cpus[index - 1] : NULL;
+    if (previous && previous->node == entry->node
+      && previous->package == entry->package
+      && previous->core == entry->core) {
+      entry->sibling = previous->sibling + 1;
+      entry->core_rank = previous->core_rank;
+    } else {
+      entry->sibling = 0;
+      entry->core_rank = previous && previous->node == entry->node
+        ? previous->core_rank + 1 : 0;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+void cpu_topology_destroy(cpu_topology_t* topology) {
+  assert(topology);
+  free(topology->cpus);
+  topology->cpus = NULL;
+  topology->cpu_count = 0;
+  topology->placement_count = 0;
+}
+
+int cpu_topology_read(int cpu, const char* name, int fallback) {
+  char path[256];
+  snprintf(path, sizeof(path), CPU_TOPOLOGY_SYSFS "/cpu%d/%s", cpu, name);
+  int value = fallback;
+  FILE* file = fopen(path, "r");
+  if (file) {
+    if (fscanf(file, "%d", &value) != 1) {
+      value = fallback;
+    }
+    fclose(file);
+  }
+  return value;
+}
+
+int cpu_topology_read_node(int cpu) {
+  char path[256];
+  snprintf(path, sizeof(path), CPU_TOPOLOGY_SYSFS "/cpu%d", cpu);
+  int node = 0;
+  DIR* directory = opendir(path);
+  if (directory) {
+    const struct dirent* entry = NULL;
+    while ((entry = readdir(directory))) {
+      if (sscanf(entry->d_name, "node%d", &node) == 1) {
+        break;
+      }
+      node = 0;
+    }
+    closedir(directory);
+  }
+  return node;
+}
+
+void cpu_topology_sort_compact(cpu_topology_t* topology) {
+  assert(topology);
+  qsort(topology->cpus, (size_t)topology->cpu_count,
+    sizeof(cpu_topology_cpu_t), cpu_topology_compare_compact);
+}
+
+void cpu_topology_sort_scatter(cpu_topology_t* topology) {
+  assert(topology);
+  qsort(topology->cpus, (size_t)topology->cpu_count,
+    sizeof(cpu_topology_cpu_t), cpu_topology_compare_scatter);
+}
+
+void cpu_topology_keep_cores(cpu_topology_t* topology) {
+  assert(topology);
+  cpu_topology_cpu_t* cpus = (cpu_topology_cpu_t*) calloc(
+    (size_t)topology->cpu_count, sizeof(cpu_topology_cpu_t));
+  if (cpus == NULL) {
+    // Every sibling is a placement, as when SMT is not avoided
+    return;
+  }
+  int64_t count = 0;
+  for (int pass = 0; pass < 2; ++pass) {
+    for (int64_t index = 0; index < topology->cpu_count; ++index) {
+      if ((topology->cpus[index].sibling == 0) == (pass == 0)) {
+        cpus[count++] = topology->cpus[index];
+      }
+    }
+    if (pass == 0) {
+      topology->placement_count = count;
+    }
+  }
+  free(topology->cpus);
+  topology->cpus = cpus;
+}
+
+int64_t cpu_topology_count_cores(void) {
+  cpu_topology_t topology;
+  if (cpu_topology_init(&topology) != EXIT_SUCCESS) {
+    cpu_topology_destroy(&topology);
+    return sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  int64_t core_count = 0;
+  for (int64_t index = 0; index < topology.cpu_count; ++index) {
+    core_count += topology.cpus[index].sibling == 0;
+  }
+  cpu_topology_destroy(&topology);
+  return core_count;
+}
+
+int cpu_topology_bind(const cpu_topology_t* topology, int64_t position) {
+  assert(topology);
+  if (topology->placement_count == 0) {
+    return EXIT_FAILURE;
+  }
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if (position < 0) {
+    for (int64_t index = 0; index < topology->cpu_count; ++index) {
+      CPU_SET(topology->cpus[index].cpu, &cpus);
+    }
+  } else {
+    CPU_SET(topology->cpus[position % topology->placement_count].cpu, &cpus);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0
+    ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int cpu_topology_compare_compact(const void* first, const void* second) {
+  const cpu_topology_cpu_t* first_cpu = (const cpu_topology_cpu_t*)first;
+  const cpu_topology_cpu_t* second_cpu = (const cpu_topology_cpu_t*)second;
+  const int differences[] = {
+    first_cpu->node - second_cpu->node,
+    first_cpu->package - second_cpu->package,
+    first_cpu->core - second_cpu->core,
+    first_cpu->sibling - second_cpu->sibling,
+    first_cpu->cpu - second_cpu->cpu,
+  };
+  for (size_t index = 0; index < sizeof(differences) / sizeof(int);
+    ++index) {
+    if (differences[index]) {
+      return differences[index];
+    }
+  }
+  return 0;
+}
+
+int cpu_topology_compare_scatter(const void* first, const void* second) {
+  const cpu_topology_cpu_t* first_cpu = (const cpu_topology_cpu_t*)first;
+  const cpu_topology_cpu_t* second_cpu = (const cpu_topology_cpu_t*)second;
+  const int differences[] = {
+    first_cpu->sibling - second_cpu->sibling,
+    first_cpu->core_rank - second_cpu->core_rank,
+    first_cpu->node - second_cpu->node,
+    first_cpu->package - second_cpu->package,
+    first_cpu->core - second_cpu->core,
+    first_cpu->cpu - second_cpu->cpu,
+  };
+  for (size_t index = 0; index < sizeof(differences) / sizeof(int);
+    ++index) {
+    if (differences[index]) {
+      return differences[index];
+    }
+  }
+  return 0;
+}
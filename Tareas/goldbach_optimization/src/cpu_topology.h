@@ -0,0 +1,97 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_CPU_TOPOLOGY_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_CPU_TOPOLOGY_H
+
+#include <stdint.h>
+
+/// Directory where Linux describes the processors
+#define CPU_TOPOLOGY_SYSFS "/sys/devices/system/cpu"
+
+/**
+ * @brief a hardware thread where the process can run.
+ */
+typedef struct cpu_topology_cpu {
+  /// Number of the processor for the operating system
+  int cpu;
+  int package;
+  int core;
+  /// NUMA node of the processor, 0 if the machine has a single node
+  int node;
+  /// Position among the hardware threads of its core, 0 for the first one
+  int sibling;
+  /// Position of its core among the cores of its node
+  int core_rank;
+} cpu_topology_cpu_t;
+
+/**
+ * @brief processors where the process can run, in the order that threads
+ * are placed on them.
+ */
+typedef struct cpu_topology {
+  /// Every processor allowed for the process
+  int64_t cpu_count;
+  cpu_topology_cpu_t* cpus;
+  /// First processors of the order where threads are placed
+  int64_t placement_count;
+} cpu_topology_t;
+
+/**
+ * @brief finds the processors allowed for the process and their cores,
+ * packages and NUMA nodes.
+ * @details reads the affinity of the process and the topology in sysfs.
+ * When sysfs cannot be read, every processor is taken as a core of its own
+ * in node 0. The processors are left in compact order.
+ * @param topology pointer to the topology to be initialized.
+ * @return an integer to check errors.
+ */
+int cpu_topology_init(cpu_topology_t* topology);
+
+/**
+ * @brief frees the processors of the topology.
+ * @param topology pointer to the topology to be destroyed.
+ */
+void cpu_topology_destroy(cpu_topology_t* topology);
+
+/**
+ * @brief orders the processors to fill a node before the next one.
+ * @details the hardware threads of a core are consecutive, so threads that
+ * share data share the caches of their cores and the memory of their node.
+ * @param topology pointer to the topology.
+ */
+void cpu_topology_sort_compact(cpu_topology_t* topology);
+
+/**
+ * @brief orders the processors to spread threads among nodes and cores.
+ * @details takes one core of every node in turns, and uses the second
+ * hardware thread of a core only when every core has a thread, so threads
+ * get the most caches and memory bandwidth.
+ * @param topology pointer to the topology.
+ */
+void cpu_topology_sort_scatter(cpu_topology_t* topology);
+
+/**
+ * @brief places threads only in the first hardware thread of every core.
+ * @details keeps the order of the processors, and moves the other siblings
+ * after the placement ones.
+ * @param topology pointer to the topology.
+ */
+void cpu_topology_keep_cores(cpu_topology_t* topology);
+
+/**
+ * @brief returns the amount of physical cores where the process can run.
+ * @return the amount of cores, or of online processors if the topology
+ * cannot be read.
+ */
+int64_t cpu_topology_count_cores(void);
+
+/**
+ * @brief pins the calling thread to a processor of the placement.
+ * @param topology pointer to the topology.
+ * @param position position of the thread, wraps around the placement. A
+ * negative position lets the thread run on every allowed processor.
+ * @return an integer to check errors.
+ */
+int cpu_topology_bind(const cpu_topology_t* topology, int64_t position);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_CPU_TOPOLOGY_H
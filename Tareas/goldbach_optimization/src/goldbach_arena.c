@@ -0,0 +1,140 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "goldbach_arena.h"
+
+/**
+ * @brief returns the bytes of a chunk of a class, including its header.
+ * @param size_class class of the chunk.
+ * @return the amount of bytes.
+ */
+size_t goldbach_arena_chunk_bytes(int64_t size_class);
+
+/**
+ * @brief carves a chunk of a class from the newest slab.
+ * @details allocates a new slab when the newest one has no room.
+ * @param arena pointer to the arena.
+ * @param size_class class of the chunk.
+ * @return the chunk, or NULL if a slab could not be allocated.
+ */
+goldbach_arena_chunk_t* goldbach_arena_carve(goldbach_arena_t* arena,
+  int64_t size_class);
+
+void goldbach_arena_init(goldbach_arena_t* arena) {
+  assert(arena);
+  for (int64_t size_class = 0; size_class < GOLDBACH_ARENA_CLASS_COUNT;
+    ++size_class) {
+    atomic_init(&arena->returned_chunks[size_class], NULL);
+    arena->free_chunks[size_class] = NULL;
+  }
+  arena->slabs = NULL;
+}
+
+void goldbach_arena_destroy(goldbach_arena_t* arena) {
+  assert(arena);
+  while (arena->slabs) {
+    goldbach_arena_slab_t* slab = arena->slabs;
+    arena->slabs = slab->next;
+    free(slab);
+  }
+  for (int64_t size_class = 0; size_class < GOLDBACH_ARENA_CLASS_COUNT;
+    ++size_class) {
+    atomic_store(&arena->returned_chunks[size_class], NULL);
+    arena->free_chunks[size_class] = NULL;
+  }
+}
+
+int64_t goldbach_arena_capacity(int64_t size_class) {
+  return (int64_t)GOLDBACH_ARENA_FIRST_ELEMENTS << size_class;
+}
+
+size_t goldbach_arena_chunk_bytes(int64_t size_class) {
+  return sizeof(goldbach_arena_chunk_t)
+    + (size_t)goldbach_arena_capacity(size_class) * sizeof(int64_t);
+}
+
+goldbach_arena_chunk_t* goldbach_arena_take(goldbach_arena_t* arena,
+  int64_t size_class) {
+  assert(size_class >= 0 && size_class < GOLDBACH_ARENA_CLASS_COUNT);
+  goldbach_arena_chunk_t* chunk = NULL;
+  if (arena == NULL) {
+    chunk = (goldbach_arena_chunk_t*) malloc(goldbach_arena_chunk_bytes(
+      size_class));
+  } else {
+    if (arena->free_chunks[size_class] == NULL) {
+      // Take every chunk freed by the other threads, no ABA problem
+      arena->free_chunks[size_class] = atomic_exchange_explicit(
+        &arena->returned_chunks[size_class], NULL, memory_order_acquire);
+    }
+    chunk = arena->free_chunks[size_class];
+    if (chunk) {
+      arena->free_chunks[size_class] = chunk->next;
+    } else {
+      chunk = goldbach_arena_carve(arena, size_class);
+    }
+  }
+
+  if (chunk) {
+    chunk->next = NULL;
+    chunk->arena = arena;
+    chunk->size_class = size_class;
+    chunk->capacity = goldbach_arena_capacity(size_class);
+    chunk->count = 0;
+    chunk->is_text = false;
+  }
+  return chunk;
+}
+
+goldbach_arena_chunk_t* goldbach_arena_take_exact(int64_t capacity) {
+  assert(capacity >= 0);
+  goldbach_arena_chunk_t* chunk = (goldbach_arena_chunk_t*) malloc(
+    sizeof(goldbach_arena_chunk_t) + (size_t)capacity * sizeof(int64_t));
+  if (chunk) {
+    chunk->next = NULL;
+    chunk->arena = NULL;
+    chunk->size_class = GOLDBACH_ARENA_EXACT_CLASS;
+    chunk->capacity = capacity;
+    chunk->count = 0;
+    chunk->is_text = false;
+  }
+  return chunk;
+}
+
+goldbach_arena_chunk_t* goldbach_arena_carve(goldbach_arena_t* arena,
+  int64_t size_class) {
+  const size_t bytes = goldbach_arena_chunk_bytes(size_class);
+  goldbach_arena_slab_t* slab = arena->slabs;
+  if (slab == NULL || slab->used + bytes > GOLDBACH_ARENA_SLAB_BYTES) {
+    // The rest of the newest slab is left unused
+    slab = (goldbach_arena_slab_t*) malloc(sizeof(goldbach_arena_slab_t)
+      + GOLDBACH_ARENA_SLAB_BYTES);
+    if (slab == NULL) {
+      return NULL;
+    }
+    slab->used = 0;
+    slab->next = arena->slabs;
+    arena->slabs = slab;
+  }
+  goldbach_arena_chunk_t* chunk = (goldbach_arena_chunk_t*)
+    (slab->bytes + slab->used);
+  slab->used += bytes;
+  return chunk;
+}
+
+void goldbach_arena_give_back(goldbach_arena_chunk_t* chunk) {
+  assert(chunk);
+  goldbach_arena_t* arena = chunk->arena;
+  if (arena == NULL) {
+    free(chunk);
+    return;
+  }
+  _Atomic(goldbach_arena_chunk_t*)* top =
+    &arena->returned_chunks[chunk->size_class];
+  chunk->next = atomic_load_explicit(top, memory_order_relaxed);
+  // The owner sees the chunk, and the elements it had, after the exchange
+  while (!atomic_compare_exchange_weak_explicit(top, &chunk->next, chunk,
+    memory_order_release, memory_order_relaxed)) {
+  }
+}
@@ -0,0 +1,118 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_ARENA_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_ARENA_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "goldbach_number_queue.h"
+
+/// Elements of the chunks of the smallest class, a multiple of 2 and 3
+#define GOLDBACH_ARENA_FIRST_ELEMENTS 12
+/// Classes of chunks, every class doubles the elements of the previous one
+#define GOLDBACH_ARENA_CLASS_COUNT 10
+/// Bytes of the blocks of memory where the chunks are carved
+#define GOLDBACH_ARENA_SLAB_BYTES (1 << 20)
+/// Class of the chunks of an exact size, allocated apart from the arenas
+#define GOLDBACH_ARENA_EXACT_CLASS -1
+
+/**
+ * @brief elements of an array of sums that never move.
+ */
+typedef struct goldbach_arena_chunk {
+  /// Next chunk of the array, or of a list of free chunks
+  struct goldbach_arena_chunk* next;
+  /// Arena that carved the chunk, NULL if it was allocated with malloc
+  struct goldbach_arena* arena;
+  int64_t size_class;
+  /// Elements of 64 bits that fit in the chunk
+  int64_t capacity;
+  /// Elements used by the array, of the width that the array chooses, or
+  /// bytes if the chunk stores text
+  int64_t count;
+  /// The elements are bytes of text formatted from the sums
+  bool is_text;
+  /// Elements of 64 bits, or twice as many of 32 bits
+  int64_t elements[];
+} goldbach_arena_chunk_t;
+
+/**
+ * @brief a block of memory of an arena.
+ */
+typedef struct goldbach_arena_slab {
+  struct goldbach_arena_slab* next;
+  /// Bytes handed out as chunks from the start of the bytes
+  size_t used;
+  _Alignas(int64_t) char bytes[];
+} goldbach_arena_slab_t;
+
+/**
+ * @brief chunks of elements of a consumer.
+ * @details only the owner takes chunks, bumping a pointer in its newest
+ * slab or reusing freed chunks of the same class, so taking a chunk never
+ * locks the global heap. Any thread frees a chunk by pushing it to a
+ * lock-free stack of its arena, and the owner takes the whole stack at once
+ * when its own free list is empty. Slabs are freed with the arena.
+ */
+typedef struct goldbach_arena {
+  /// Chunks freed by any thread, for every class
+  _Atomic(goldbach_arena_chunk_t*) returned_chunks[GOLDBACH_ARENA_CLASS_COUNT];
+  char padding_returned[GOLDBACH_NUMBER_QUEUE_CACHE_LINE];
+  /// Chunks that the owner can reuse, for every class
+  goldbach_arena_chunk_t* free_chunks[GOLDBACH_ARENA_CLASS_COUNT];
+  goldbach_arena_slab_t* slabs;
+  char padding_owner[GOLDBACH_NUMBER_QUEUE_CACHE_LINE];
+} goldbach_arena_t;
+
+/**
+ * @brief initialize the goldbach_arena struct.
+ * @details no memory is allocated until the first chunk, so the slabs are
+ * first touched by the owner.
+ * @param arena pointer to the arena to be initialized.
+ */
+void goldbach_arena_init(goldbach_arena_t* arena);
+
+/**
+ * @brief destroys the goldbach_arena struct.
+ * @details frees every slab, the chunks of the arena must not be used.
+ * @param arena pointer to the arena to be destroyed.
+ */
+void goldbach_arena_destroy(goldbach_arena_t* arena);
+
+/**
+ * @brief returns an empty chunk of a class.
+ * @details only called by the owner of the arena.
+ * @param arena pointer to the arena, NULL to allocate the chunk with malloc.
+ * @param size_class class of the chunk, less than GOLDBACH_ARENA_CLASS_COUNT.
+ * @return the chunk, or NULL if it could not be allocated.
+ */
+goldbach_arena_chunk_t* goldbach_arena_take(goldbach_arena_t* arena,
+  int64_t size_class);
+
+/**
+ * @brief returns an empty chunk of an exact amount of elements.
+ * @details the chunk is allocated with malloc, because its size can not be
+ * reused by other arrays.
+ * @param capacity amount of elements of 64 bits of the chunk.
+ * @return the chunk, or NULL if it could not be allocated.
+ */
+goldbach_arena_chunk_t* goldbach_arena_take_exact(int64_t capacity);
+
+/**
+ * @brief frees a chunk.
+ * @details thread-safe, the chunk goes back to the arena that carved it.
+ * @param chunk the chunk.
+ */
+void goldbach_arena_give_back(goldbach_arena_chunk_t* chunk);
+
+/**
+ * @brief returns the amount of elements of the chunks of a class.
+ * @param size_class class of the chunks.
+ * @return the amount of elements.
+ */
+int64_t goldbach_arena_capacity(int64_t size_class);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_ARENA_H
@@ -2,97 +2,576 @@
 
 #include "goldbach_calculator.h"
 
+/**
+ * @brief calculates one unit in the array of its number.
+ * @details a unit that is a part of a split number is calculated in its own
+ * array, which is joined to the array of the number with the other parts.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param primes table of primes that covers the number.
+ * @param goldbach_number the unit.
+ * @param thread_number number of the consumer that calculates the unit.
+ * @param is_finished set to true if every unit of the number is finished.
+ * @return an integer to check errors.
+ */
+int goldbach_calculator_calculate_unit(goldbach_pthread_t* goldbach_pthread,
+  const prime_table_t* primes, const goldbach_number_t* goldbach_number,
+  int64_t thread_number, bool* is_finished);
+
+/**
+ * @brief formats the sums of a finished number as text, if it is close to
+ * the writer.
+ * @details the consumers format the text of the numbers in parallel, and the
+ * writer only copies it. The text takes more memory than the sums, so only
+ * the numbers that are at most GOLDBACH_CALCULATOR_RENDER_AHEAD per consumer
+ * after the printed ones are rendered, right before they are published. The
+ * writer formats the sums of the others, and of the numbers whose text could
+ * not be allocated.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param index index of the number, every unit of it is finished.
+ * @param thread_number number of the consumer that finished the number.
+ */
+void goldbach_calculator_render(goldbach_pthread_t* goldbach_pthread,
+  int64_t index, int64_t thread_number);
+
+/**
+ * @brief calls the conjecture of the parity of the number.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param primes table of primes that covers the number.
+ * @param goldbach_number the number and the range of addends.
+ * @param goldbach_sums array where the sums are stored.
+ * @return an integer to check errors.
+ */
+int goldbach_calculator_calculate_range(goldbach_pthread_t* goldbach_pthread,
+  const prime_table_t* primes, const goldbach_number_t* goldbach_number,
+  goldbach_sums_array_t* goldbach_sums);
+
+/**
+ * @brief calculates a part of a number by slices of its range of addends.
+ * @details used by the steal schedule. Before every slice, if a consumer is
+ * idle and the deque of this consumer is empty, the rest of the range is cut
+ * in two halves of the same work and the second half is pushed as a new
+ * task that the idle consumer can steal.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param primes table of primes that covers the number.
+ * @param goldbach_number the part.
+ * @param thread_number number of the consumer that calculates the part.
+ * @param goldbach_sums array of the part.
+ * @return an integer to check errors.
+ */
+int goldbach_calculator_calculate_slices(goldbach_pthread_t* goldbach_pthread,
+  const prime_table_t* primes, const goldbach_number_t* goldbach_number,
+  int64_t thread_number, goldbach_sums_array_t* goldbach_sums);
+
+/**
+ * @brief appends the goldbach sums of an even number to its array.
+ * @details iterates the primes of the table up to half of the number and
+ * looks the second addend up in the table.
+ * @param primes table of primes that covers the number.
+ * @param number even number whose goldbach sums will be calculated.
+ * @param start smallest first addend of the sums.
+ * @param finish first addends from finish are not calculated.
+ * @param goldbach_sums array where the sums are appended.
+ * @return an integer to check errors.
+ */
+int goldbach_calculator_strong_list(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish,
+  goldbach_sums_array_t* goldbach_sums);
+
+/**
+ * @brief returns the amount of goldbach sums of an even number.
+ * @details same iteration than goldbach_calculator_strong_list(), but the
+ * sums are only counted.
+ * @param primes table of primes that covers the number.
+ * @param number even number whose goldbach sums will be counted.
+ * @param start smallest first addend of the sums.
+ * @param finish first addends from finish are not counted.
+ * @return the amount of sums.
+ */
+int64_t goldbach_calculator_count_strong(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish);
+
+/**
+ * @brief appends the goldbach sums of an even number to its array.
+ * @details walks every integer up to half of the number and looks both
+ * addends up in the table.
+ * @param primes table of primes, numbers outside of it are tested apart.
+ * @param number even number whose goldbach sums will be calculated.
+ * @param start smallest first addend of the sums.
+ * @param finish first addends from finish are not calculated.
+ * @param goldbach_sums array where the sums are appended.
+ * @return an integer to check errors.
+ */
+int goldbach_calculator_strong_scan(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish,
+  goldbach_sums_array_t* goldbach_sums);
+
+/**
+ * @brief appends the goldbach sums of an odd number to its array.
+ * @details walks every pair of integers for the two smallest addends, the
+ * pairs whose first addend is composite are skipped.
+ * @param primes table of primes, numbers outside of it are tested apart.
+ * @param number odd number whose goldbach sums will be calculated.
+ * @param start smallest first addend of the sums.
+ * @param finish first addends from finish are not calculated.
+ * @param goldbach_sums array where the sums are appended.
+ * @return an integer to check errors.
+ */
+int goldbach_calculator_weak_scan(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish,
+  goldbach_sums_array_t* goldbach_sums);
+
+/**
+ * @brief appends the goldbach sums of an odd number to its array.
+ * @details iterates the primes of the table for the two smallest addends
+ * and looks the last addend up in the table. The sums are appended in the
+ * same order than goldbach_calculator_weak_scan().
+ * @param primes table of primes that covers the number.
+ * @param number odd number whose goldbach sums will be calculated.
+ * @param start smallest first addend of the sums.
+ * @param finish first addends from finish are not calculated.
+ * @param goldbach_sums array where the sums are appended.
+ * @return an integer to check errors.
+ */
+int goldbach_calculator_weak_list(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish,
+  goldbach_sums_array_t* goldbach_sums);
+
+/**
+ * @brief returns the amount of goldbach sums of an odd number.
+ * @details same iteration than goldbach_calculator_weak_list(), but the sums
+ * are only counted.
+ * @param primes table of primes that covers the number.
+ * @param number odd number whose goldbach sums will be counted.
+ * @param start smallest first addend of the sums.
+ * @param finish first addends from finish are not counted.
+ * @return the amount of sums.
+ */
+int64_t goldbach_calculator_count_weak(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish);
+
 void* goldbach_calculator_calculate_goldbach(void* data) {
   assert(data);
   const private_data_t* private_data = (private_data_t*)data;
   goldbach_pthread_t* goldbach_pthread = private_data->goldbach_pthread;
   // Calculate number sums
-  goldbach_number_t goldbach_number = private_data->goldbach_number;
-  int64_t number = goldbach_number.number;
-  int64_t index = goldbach_number.index;
+  const goldbach_number_t* goldbach_number = &private_data->goldbach_number;
+  int64_t number = goldbach_number->number;
+  // The sums of positive numbers are only counted
+  const bool is_counted = number > 0;
   // Change number to positive if it is negative
   if (number < 0) {
     number *= -1;
   }
 
+  bool is_finished = true;
   // If number is smaller than 6, it doesn't have any goldbach sum
   if (number > 5) {
-    if (number % 2 == 0) {
-      goldbach_calculator_strong_conjecture(goldbach_pthread, number, index);
-    } else {
-      goldbach_calculator_weak_conjecture(goldbach_pthread, number, index);
+    // The pair table is filled up to its limit, the sieve must cover it
+    int64_t covered = is_counted
+      && number <= goldbach_pthread->pair_table.limit
+      ? goldbach_pthread->pair_table.limit : number;
+    // No sieve covers huge numbers, so it is only grown up to the smallest
+    // addends of the unit, and the addends past it are tested by Miller-Rabin
+    if (number > PRIME_SIEVE_MAX_LIMIT) {
+      covered = goldbach_number->finish - 1;
     }
+    // Help to build the sieve until it covers the number
+    const prime_table_t* primes = prime_sieve_acquire(&goldbach_pthread->sieve,
+      private_data->thread_number, covered);
+    // Measure the actual cost of the unit to tune the cost model
+    struct timespec start_time;
+    if (goldbach_pthread->elapsed_times) {
+      clock_gettime(CLOCK_MONOTONIC, &start_time);
+    }
+    // The unit is still finished, so the writer does not wait for it
+    if (goldbach_calculator_calculate_unit(goldbach_pthread, primes,
+      goldbach_number, private_data->thread_number, &is_finished)
+      != EXIT_SUCCESS) {
+      atomic_store(&goldbach_pthread->has_failed, true);
+    }
+    if (goldbach_pthread->elapsed_times) {
+      struct timespec finish_time;
+      clock_gettime(CLOCK_MONOTONIC, &finish_time);
+      atomic_fetch_add_explicit(
+        &goldbach_pthread->elapsed_times[goldbach_number->index],
+        (finish_time.tv_sec - start_time.tv_sec) * INT64_C(1000000000)
+        + (finish_time.tv_nsec - start_time.tv_nsec), memory_order_relaxed);
+    }
+    prime_sieve_release(&goldbach_pthread->sieve, private_data->thread_number);
   }
 
+  // The writer prints the number when its last unit finishes
+  if (is_finished && goldbach_pthread->reorder_buffer) {
+    goldbach_calculator_render(goldbach_pthread, goldbach_number->index,
+      private_data->thread_number);
+    goldbach_reorder_buffer_publish(goldbach_pthread->reorder_buffer,
+      goldbach_number->index);
+  }
   return NULL;
 }
 
+int goldbach_calculator_calculate_unit(goldbach_pthread_t* goldbach_pthread,
+  const prime_table_t* primes, const goldbach_number_t* goldbach_number,
+  int64_t thread_number, bool* is_finished) {
+  const int64_t index = goldbach_number->index;
+  *is_finished = true;
+  goldbach_split_t* split = goldbach_pthread_get_split(goldbach_pthread, index);
+  goldbach_sums_array_t* goldbach_sums = goldbach_pthread_get_sums(
+    goldbach_pthread, index);
+  goldbach_part_t* part = NULL;
+  if (split->part_count > 1) {
+    part = goldbach_split_create_part(goldbach_number->number,
+      goldbach_number->start);
+    if (part == NULL) {
+      // The part still finishes, so the number is printed
+      goldbach_split_finish_part(split, NULL, goldbach_sums, is_finished);
+      return EXIT_FAILURE;
+    }
+    goldbach_sums = &part->sums;
+  }
+  // The sums grow in chunks of this consumer, without the global heap
+  goldbach_sums->arena = &goldbach_pthread->arenas[thread_number];
+
+  int error = EXIT_SUCCESS;
+  if (part && goldbach_pthread->options.schedule == GOLDBACH_SCHEDULE_STEAL) {
+    error = goldbach_calculator_calculate_slices(goldbach_pthread, primes,
+      goldbach_number, thread_number, goldbach_sums);
+  } else {
+    error = goldbach_calculator_calculate_range(goldbach_pthread, primes,
+      goldbach_number, goldbach_sums);
+  }
+
+  if (part) {
+    const int join_error = goldbach_split_finish_part(split, part,
+      goldbach_pthread_get_sums(goldbach_pthread, index), is_finished);
+    error = error ? error : join_error;
+  }
+  return error;
+}
+
+void goldbach_calculator_render(goldbach_pthread_t* goldbach_pthread,
+  int64_t index, int64_t thread_number) {
+  if (goldbach_reorder_buffer_get_distance(goldbach_pthread->reorder_buffer,
+    index) < GOLDBACH_CALCULATOR_RENDER_AHEAD
+    * goldbach_pthread->consumer_count) {
+    goldbach_sums_array_t* goldbach_sums = goldbach_pthread_get_sums(
+      goldbach_pthread, index);
+    // Any consumer can finish a split number, the text uses its own arena
+    goldbach_sums->arena = &goldbach_pthread->arenas[thread_number];
+    goldbach_sums_array_render(goldbach_sums);
+  }
+}
+
+int goldbach_calculator_calculate_range(goldbach_pthread_t* goldbach_pthread,
+  const prime_table_t* primes, const goldbach_number_t* goldbach_number,
+  goldbach_sums_array_t* goldbach_sums) {
+  if (goldbach_number->number % 2 == 0) {
+    return goldbach_calculator_strong_conjecture(goldbach_pthread, primes,
+      goldbach_number, goldbach_sums);
+  }
+  return goldbach_calculator_weak_conjecture(goldbach_pthread, primes,
+    goldbach_number, goldbach_sums);
+}
+
+int goldbach_calculator_calculate_slices(goldbach_pthread_t* goldbach_pthread,
+  const prime_table_t* primes, const goldbach_number_t* goldbach_number,
+  int64_t thread_number, goldbach_sums_array_t* goldbach_sums) {
+  goldbach_split_t* split = goldbach_pthread_get_split(goldbach_pthread,
+    goldbach_number->index);
+  goldbach_deque_t* deque = &goldbach_pthread->deques[thread_number];
+  const int64_t number = llabs(goldbach_number->number);
+  const double cost = goldbach_cost_estimate(goldbach_number->number,
+    goldbach_pthread->pair_table.limit, goldbach_pthread->options.kernel);
+  int64_t finish = goldbach_number->finish;
+  goldbach_number_t slice = *goldbach_number;
+  int error = EXIT_SUCCESS;
+
+  while (slice.start < finish && !error) {
+    // Give the second half of the rest to an idle consumer, if it is worth
+    const double rest = cost * goldbach_split_share(number, slice.start,
+      finish);
+    if (rest > 2 * GOLDBACH_SPLIT_PART_COST
+      && atomic_load_explicit(&goldbach_pthread->idle_count,
+      memory_order_relaxed) > 0 && goldbach_deque_is_empty(deque)) {
+      const int64_t middle = goldbach_split_cut(number, slice.start, finish,
+        0.5);
+      goldbach_number_t* task = middle < finish ? (goldbach_number_t*)
+        malloc(sizeof(goldbach_number_t)) : NULL;
+      if (task) {
+        *task = *goldbach_number;
+        task->start = middle;
+        task->finish = finish;
+        // The new part must be pending before a thief can finish it
+        goldbach_split_add_part(split);
+        atomic_fetch_add(&goldbach_pthread->pending_task_count, 1);
+        if (goldbach_deque_push(deque, task) == EXIT_SUCCESS) {
+          goldbach_pthread_wake_thieves(goldbach_pthread);
+          finish = middle;
+        } else {
+          atomic_fetch_sub(&split->pending_count, 1);
+          atomic_fetch_sub(&goldbach_pthread->pending_task_count, 1);
+          free(task);
+        }
+      }
+    }
+
+    // A slice takes about the operations of a planned part
+    const double share = cost * goldbach_split_share(number, slice.start,
+      finish);
+    slice.finish = share > GOLDBACH_SPLIT_PART_COST ? goldbach_split_cut(
+      number, slice.start, finish, GOLDBACH_SPLIT_PART_COST / share) : finish;
+    error = goldbach_calculator_calculate_range(goldbach_pthread, primes,
+      &slice, goldbach_sums);
+    slice.start = slice.finish;
+  }
+  return error;
+}
+
 int goldbach_calculator_strong_conjecture(goldbach_pthread_t* goldbach_pthread,
-  int64_t number, int64_t index_number) {
+  const prime_table_t* primes, const goldbach_number_t* goldbach_number,
+  goldbach_sums_array_t* goldbach_sums) {
   assert(goldbach_pthread);
+  const int64_t number = llabs(goldbach_number->number);
+  const int64_t start = goldbach_number->start;
+  const int64_t finish = goldbach_number->finish;
+  // The primes are only iterated for numbers inside of the table
+  if (goldbach_pthread->options.kernel == GOLDBACH_KERNEL_LIST
+    && number <= primes->limit) {
+    // Only the amount of sums of positive numbers is printed
+    if (!goldbach_sums->is_negative_number) {
+      goldbach_pair_table_t* pair_table = &goldbach_pthread->pair_table;
+      if (number <= pair_table->limit && primes->limit >= pair_table->limit) {
+        // Numbers counted from the table are never split
+        assert(goldbach_pthread_get_split(goldbach_pthread,
+          goldbach_number->index)->part_count == 1);
+        goldbach_pair_table_require(pair_table, primes);
+        goldbach_sums_array_add_count(goldbach_sums,
+          goldbach_pair_table_count_strong(pair_table, number));
+      } else {
+        goldbach_sums_array_add_count(goldbach_sums,
+          goldbach_calculator_count_strong(primes, number, start, finish));
+      }
+      return EXIT_SUCCESS;
+    }
+    // A first pass counts the sums to store them in one allocation
+    if (goldbach_pthread->options.prealloc && goldbach_sums_array_reserve(
+      goldbach_sums, goldbach_calculator_count_strong(primes, number, start,
+      finish)) != EXIT_SUCCESS) {
+      return EXIT_FAILURE;
+    }
+    return goldbach_calculator_strong_list(primes, number, start, finish,
+      goldbach_sums);
+  }
+  return goldbach_calculator_strong_scan(primes, number, start, finish,
+    goldbach_sums);
+}
+
+int goldbach_calculator_strong_list(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish,
+  goldbach_sums_array_t* goldbach_sums) {
   int error = EXIT_SUCCESS;
+  // 2 is not an addend of the even numbers bigger than 4, and the smallest
+  // addend is not bigger than half of the number
+  const int64_t first_bit = prime_table_first_bit(start);
+  const int64_t last_bit = prime_table_last_bit(finish - 1 < number / 2
+    ? finish - 1 : number / 2);
 
-  for (int64_t num1 = 2, num2 = number - 2; num1 <= num2 && !error;
-    ++num1, --num2) {
-    if (isPrime(num1) && isPrime(num2)) {
-      if (num1 + num2 == number) {
-        error = goldbach_sums_array_append(goldbach_pthread
-          ->goldbach_sums[index_number], num1);
-        if (error) {
-          break;
-        }
-        error = goldbach_sums_array_append(goldbach_pthread
-          ->goldbach_sums[index_number], num2);
-        if (error) {
-          break;
-        }
+  for (int64_t word_index = first_bit / PRIME_TABLE_WORD_BITS;
+    word_index <= last_bit / PRIME_TABLE_WORD_BITS && !error; ++word_index) {
+    uint64_t word = prime_table_get_word(primes, word_index, first_bit,
+      last_bit);
+    while (word && !error) {
+      const int64_t num1 = 2 * (word_index * PRIME_TABLE_WORD_BITS
+        + __builtin_ctzll(word)) + 1;
+      const int64_t num2 = number - num1;
+      // Both addends of an even number bigger than 4 are odd
+      if (prime_table_is_odd_prime(primes, num2)) {
+        const int64_t sum[] = {num1, num2};
+        error = goldbach_sums_array_append_sum(goldbach_sums, sum, 2);
       }
+      word &= word - 1;
+    }
+  }
+  return error;
+}
+
+int64_t goldbach_calculator_count_strong(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish) {
+  int64_t sum_count = 0;
+  const int64_t first_bit = prime_table_first_bit(start);
+  const int64_t last_bit = prime_table_last_bit(finish - 1 < number / 2
+    ? finish - 1 : number / 2);
+
+  for (int64_t word_index = first_bit / PRIME_TABLE_WORD_BITS;
+    word_index <= last_bit / PRIME_TABLE_WORD_BITS; ++word_index) {
+    uint64_t word = prime_table_get_word(primes, word_index, first_bit,
+      last_bit);
+    while (word) {
+      const int64_t num1 = 2 * (word_index * PRIME_TABLE_WORD_BITS
+        + __builtin_ctzll(word)) + 1;
+      sum_count += prime_table_is_odd_prime(primes, number - num1);
+      word &= word - 1;
+    }
+  }
+  return sum_count;
+}
+
+int goldbach_calculator_strong_scan(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish,
+  goldbach_sums_array_t* goldbach_sums) {
+  int error = EXIT_SUCCESS;
+  const int64_t first = start > 2 ? start : 2;
+
+  for (int64_t num1 = first, num2 = number - first; num1 <= num2
+    && num1 < finish && !error; ++num1, --num2) {
+    if (prime_table_is_prime(primes, num1)
+      && prime_table_is_prime(primes, num2)) {
+      const int64_t sum[] = {num1, num2};
+      error = goldbach_sums_array_append_sum(goldbach_sums, sum, 2);
     }
   }
   return error;
 }
 
 int goldbach_calculator_weak_conjecture(goldbach_pthread_t* goldbach_pthread,
-  int64_t number, int64_t index_number) {
+  const prime_table_t* primes, const goldbach_number_t* goldbach_number,
+  goldbach_sums_array_t* goldbach_sums) {
   assert(goldbach_pthread);
+  const int64_t number = llabs(goldbach_number->number);
+  const int64_t start = goldbach_number->start;
+  const int64_t finish = goldbach_number->finish;
+  // The primes are only iterated for numbers inside of the table
+  if (goldbach_pthread->options.kernel == GOLDBACH_KERNEL_LIST
+    && number <= primes->limit) {
+    // Only the amount of sums of positive numbers is printed
+    if (!goldbach_sums->is_negative_number) {
+      goldbach_pair_table_t* pair_table = &goldbach_pthread->pair_table;
+      if (number <= pair_table->limit && primes->limit >= pair_table->limit) {
+        // Numbers counted from the table are never split
+        assert(goldbach_pthread_get_split(goldbach_pthread,
+          goldbach_number->index)->part_count == 1);
+        goldbach_pair_table_require(pair_table, primes);
+        goldbach_sums_array_add_count(goldbach_sums,
+          goldbach_pair_table_count_weak(pair_table, primes, number));
+      } else {
+        goldbach_sums_array_add_count(goldbach_sums,
+          goldbach_calculator_count_weak(primes, number, start, finish));
+      }
+      return EXIT_SUCCESS;
+    }
+    // A first pass counts the sums to store them in one allocation
+    if (goldbach_pthread->options.prealloc && goldbach_sums_array_reserve(
+      goldbach_sums, goldbach_calculator_count_weak(primes, number, start,
+      finish)) != EXIT_SUCCESS) {
+      return EXIT_FAILURE;
+    }
+    return goldbach_calculator_weak_list(primes, number, start, finish,
+      goldbach_sums);
+  }
+  return goldbach_calculator_weak_scan(primes, number, start, finish,
+    goldbach_sums);
+}
+
+int goldbach_calculator_weak_list(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish,
+  goldbach_sums_array_t* goldbach_sums) {
   int error = EXIT_SUCCESS;
+  // 2 is only the smallest addend of 2 + 2 + (number - 4)
+  if (start <= 2 && 2 < finish && prime_table_is_prime(primes, number - 4)) {
+    const int64_t sum[] = {2, 2, number - 4};
+    error = goldbach_sums_array_append_sum(goldbach_sums, sum, 3);
+  }
+  // The smallest addend can not be bigger than a third of the number
+  const int64_t first_bit = prime_table_first_bit(start);
+  const int64_t last_bit = prime_table_last_bit(finish - 1 < number / 3
+    ? finish - 1 : number / 3);
 
-  for (int start = 2, last = number - start; start <= last; start++, last--) {
-    for (int medium = start, last_2 = last - medium; medium <= last_2;
-      medium++, last_2--) {
-      if (start + medium + last_2 == number && isPrime(start) &&
-        isPrime(medium) && isPrime(last_2)) {
-        error = goldbach_sums_array_append(goldbach_pthread
-            ->goldbach_sums[index_number], start);;
-        if (error) {
-          break;
-        }
-        error = goldbach_sums_array_append(goldbach_pthread
-            ->goldbach_sums[index_number], medium);
-        if (error) {
-          break;
-        }
-        error = goldbach_sums_array_append(goldbach_pthread
-            ->goldbach_sums[index_number], last_2);
-        if (error) {
-          break;
+  for (int64_t word_index = first_bit / PRIME_TABLE_WORD_BITS;
+    word_index <= last_bit / PRIME_TABLE_WORD_BITS && !error; ++word_index) {
+    uint64_t word = prime_table_get_word(primes, word_index, first_bit,
+      last_bit);
+    while (word && !error) {
+      const int64_t num1 = 2 * (word_index * PRIME_TABLE_WORD_BITS
+        + __builtin_ctzll(word)) + 1;
+      // The medium addend is not bigger than the last one
+      const int64_t medium_last_bit = prime_table_last_bit((number - num1)
+        / 2);
+      for (int64_t medium_index = word_index; medium_index <= medium_last_bit
+        / PRIME_TABLE_WORD_BITS && !error; ++medium_index) {
+        uint64_t medium_word = prime_table_get_word(primes, medium_index,
+          num1 >> 1, medium_last_bit);
+        while (medium_word && !error) {
+          const int64_t medium = 2 * (medium_index * PRIME_TABLE_WORD_BITS
+            + __builtin_ctzll(medium_word)) + 1;
+          // The three addends of an odd number are odd, except 2 + 2 + p
+          const int64_t last = number - num1 - medium;
+          if (prime_table_is_odd_prime(primes, last)) {
+            const int64_t sum[] = {num1, medium, last};
+            error = goldbach_sums_array_append_sum(goldbach_sums, sum, 3);
+          }
+          medium_word &= medium_word - 1;
         }
       }
+      word &= word - 1;
     }
   }
   return error;
 }
 
-bool isPrime(int64_t number) {
-  bool isPrime = true;
-  int64_t number_sqrt = (int64_t)sqrt((double)number);
-  if (number % 2 == 0 && 2 < number) {
-    isPrime = false;
+int64_t goldbach_calculator_count_weak(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish) {
+  int64_t sum_count = start <= 2 && 2 < finish
+    && prime_table_is_prime(primes, number - 4);
+  const int64_t first_bit = prime_table_first_bit(start);
+  const int64_t last_bit = prime_table_last_bit(finish - 1 < number / 3
+    ? finish - 1 : number / 3);
+
+  for (int64_t word_index = first_bit / PRIME_TABLE_WORD_BITS;
+    word_index <= last_bit / PRIME_TABLE_WORD_BITS; ++word_index) {
+    uint64_t word = prime_table_get_word(primes, word_index, first_bit,
+      last_bit);
+    while (word) {
+      const int64_t num1 = 2 * (word_index * PRIME_TABLE_WORD_BITS
+        + __builtin_ctzll(word)) + 1;
+      const int64_t rest = number - num1;
+      const int64_t medium_last_bit = prime_table_last_bit(rest / 2);
+      for (int64_t medium_index = word_index; medium_index <= medium_last_bit
+        / PRIME_TABLE_WORD_BITS; ++medium_index) {
+        uint64_t medium_word = prime_table_get_word(primes, medium_index,
+          num1 >> 1, medium_last_bit);
+        while (medium_word) {
+          const int64_t medium = 2 * (medium_index * PRIME_TABLE_WORD_BITS
+            + __builtin_ctzll(medium_word)) + 1;
+          sum_count += prime_table_is_odd_prime(primes, rest - medium);
+          medium_word &= medium_word - 1;
+        }
+      }
+      word &= word - 1;
+    }
   }
-  for (int64_t i = 3; i < number_sqrt + 1 && isPrime; i+=2) {
-    if (number % i == 0) {
-      isPrime = false;
+  return sum_count;
+}
+
+int goldbach_calculator_weak_scan(const prime_table_t* primes,
+  int64_t number, int64_t start, int64_t finish,
+  goldbach_sums_array_t* goldbach_sums) {
+  int error = EXIT_SUCCESS;
+  const int64_t first = start > 2 ? start : 2;
+
+  for (int64_t num1 = first, last = number - num1; num1 <= last
+    && num1 < finish && !error; num1++, last--) {
+    // Skip the inner loop, no sum starting with a composite number is valid
+    if (!prime_table_is_prime(primes, num1)) {
+      continue;
+    }
+    for (int64_t medium = num1, last_2 = last - medium; medium <= last_2
+      && !error; medium++, last_2--) {
+      if (prime_table_is_prime(primes, medium)
+        && prime_table_is_prime(primes, last_2)) {
+        const int64_t sum[] = {num1, medium, last_2};
+        error = goldbach_sums_array_append_sum(goldbach_sums, sum, 3);
+      }
     }
   }
-  return isPrime;
+  return error;
 }
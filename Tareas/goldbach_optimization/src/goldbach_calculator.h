@@ -9,10 +9,16 @@
 #include <pthread.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <time.h>
 #include <unistd.h>
 #include "array_int64.h"
 #include "common.h"
 #include "goldbach_sums_array.h"
+#include "prime_sieve.h"
+
+/// Numbers per consumer after the printed ones whose sums are rendered as
+/// text by the consumers, the writer formats the sums of the others
+#define GOLDBACH_CALCULATOR_RENDER_AHEAD 2
 
 /**
  * @brief constructs an array with the goldbach sums.
@@ -30,12 +36,15 @@ void* goldbach_calculator_calculate_goldbach(void* data);
  * is the amount of goldbach sums of the number. the next positions are the
  * numbers that conform the sums (they will be accessed in pairs to print).
  * @param goldbach_pthread struct that contains the shared data of the threads.
- * @param number number whose goldbach sums will be calculated.
- * @param index_number index of number to be calculated.
+ * @param primes table of primes that covers the number.
+ * @param goldbach_number number whose goldbach sums will be calculated, only
+ * the sums whose smallest addend is in [start, finish) are calculated.
+ * @param goldbach_sums array where the sums are stored.
  * @return an integer to check errors.
  */
 int goldbach_calculator_strong_conjecture(goldbach_pthread_t* goldbach_pthread,
-  int64_t number, int64_t index_number);
+  const prime_table_t* primes, const goldbach_number_t* goldbach_number,
+  goldbach_sums_array_t* goldbach_sums);
 
 /**
  * @brief constructs an array with the goldbach sums
@@ -43,20 +52,14 @@ int goldbach_calculator_strong_conjecture(goldbach_pthread_t* goldbach_pthread,
  * is the amount of goldbach sums of the number. the next positions are the
  * numbers that conform the sums (they will be accessed int trios to print).
  * @param goldbach_pthread struct that contains the shared data of the threads.
- * @param number number whose goldbach sums will be calculated.
- * @param index_number index of number to be calculated.
+ * @param primes table of primes that covers the number.
+ * @param goldbach_number number whose goldbach sums will be calculated, only
+ * the sums whose smallest addend is in [start, finish) are calculated.
+ * @param goldbach_sums array where the sums are stored.
  * @return an integer to check errors.
  */
 int goldbach_calculator_weak_conjecture(goldbach_pthread_t* goldbach_pthread,
-  int64_t number, int64_t index_number);
-
-/**
- * @brief returns if a number is a prime number
- * @details determines if a number is a prime number by checking if it
- * has more than two divisors
- * @param number the number
- * @return true if a number is a prime number
- */
-bool isPrime(int64_t number);
+  const prime_table_t* primes, const goldbach_number_t* goldbach_number,
+  goldbach_sums_array_t* goldbach_sums);
 
 #endif  // TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_CALCULATOR_H
@@ -0,0 +1,54 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+
+#include "goldbach_claim.h"
+
+void goldbach_claim_init(goldbach_claim_t* claim, int64_t fixed_size) {
+  assert(claim);
+  assert(fixed_size >= 0);
+  claim->fixed_size = fixed_size;
+  atomic_init(&claim->unit_time, 0);
+}
+
+int64_t goldbach_claim_size(goldbach_claim_t* claim, int64_t remaining,
+  int64_t consumer_count) {
+  assert(claim);
+  if (claim->fixed_size > 0) {
+    return claim->fixed_size;
+  }
+  const int64_t unit_time = atomic_load_explicit(&claim->unit_time,
+    memory_order_relaxed);
+  // The first claim is measured with one unit
+  int64_t size = 1;
+  if (unit_time > 0) {
+    size = GOLDBACH_CLAIM_TARGET_NS / unit_time;
+  }
+  if (size > GOLDBACH_CLAIM_MAX_UNITS) {
+    size = GOLDBACH_CLAIM_MAX_UNITS;
+  }
+  // Leave at least two claims for every consumer at the end
+  const int64_t balanced = remaining / (2 * consumer_count);
+  if (size > balanced) {
+    size = balanced;
+  }
+  return size > 0 ? size : 1;
+}
+
+void goldbach_claim_record(goldbach_claim_t* claim, int64_t unit_count,
+  const struct timespec* start_time) {
+  assert(claim);
+  assert(start_time);
+  struct timespec finish_time;
+  clock_gettime(CLOCK_MONOTONIC, &finish_time);
+  const int64_t elapsed = (finish_time.tv_sec - start_time->tv_sec)
+    * INT64_C(1000000000) + (finish_time.tv_nsec - start_time->tv_nsec);
+  // A unit of 0 ns would look like a claim that was never measured
+  int64_t sample = elapsed / (unit_count > 0 ? unit_count : 1);
+  sample = sample > 0 ? sample : 1;
+  const int64_t unit_time = atomic_load_explicit(&claim->unit_time,
+    memory_order_relaxed);
+  // The last claim weights an eighth of the average
+  atomic_store_explicit(&claim->unit_time, unit_time == 0 ? sample
+    : unit_time + (sample - unit_time) / 8, memory_order_relaxed);
+}
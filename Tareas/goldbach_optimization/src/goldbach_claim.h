@@ -0,0 +1,60 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_CLAIM_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_CLAIM_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+
+/// Nanoseconds of work that an adaptive claim tries to hand out at once
+#define GOLDBACH_CLAIM_TARGET_NS 50000
+/// Most units handed out by an adaptive claim
+#define GOLDBACH_CLAIM_MAX_UNITS 256
+
+/**
+ * @brief chooses how many units are handed out with one synchronization.
+ * @details small numbers take less than the atomic operations, semaphores
+ * and queue slots that hand them out, so units are claimed in batches. With
+ * a fixed size every claim takes that many units. Otherwise the size is the
+ * target time divided by the recent time of a unit, an average of the
+ * claims that weights the last ones the most. Claims are cut near the end,
+ * so the last units are still balanced among the consumers.
+ */
+typedef struct goldbach_claim {
+  /// Units of every claim, 0 to adapt them to the runtimes
+  int64_t fixed_size;
+  /// Recent nanoseconds per unit, 0 until a claim is measured
+  atomic_int_fast64_t unit_time;
+} goldbach_claim_t;
+
+/**
+ * @brief initialize the goldbach_claim struct.
+ * @param claim pointer to the claim to be initialized.
+ * @param fixed_size units of every claim, 0 to adapt them.
+ */
+void goldbach_claim_init(goldbach_claim_t* claim, int64_t fixed_size);
+
+/**
+ * @brief returns the amount of units of the next claim.
+ * @param claim pointer to the claim.
+ * @param remaining units that are not claimed yet.
+ * @param consumer_count amount of consumers that share the units.
+ * @return the amount of units, at least 1.
+ */
+int64_t goldbach_claim_size(goldbach_claim_t* claim, int64_t remaining,
+  int64_t consumer_count);
+
+/**
+ * @brief adds the runtime of a claim to the recent time of a unit.
+ * @details only needed when the size is not fixed. Thread-safe, an update
+ * can be lost when two consumers record at the same time, which only delays
+ * the adaptation.
+ * @param claim pointer to the claim.
+ * @param unit_count units calculated in the claim.
+ * @param start_time when the claim started, from CLOCK_MONOTONIC.
+ */
+void goldbach_claim_record(goldbach_claim_t* claim, int64_t unit_count,
+  const struct timespec* start_time);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_CLAIM_H
@@ -0,0 +1,45 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "goldbach_cost.h"
+
+double goldbach_cost_estimate_pi(int64_t number) {
+  return number < 3 ? 1.0 : (double)number / log((double)number);
+}
+
+goldbach_cost_class_t goldbach_cost_classify(int64_t number,
+  int64_t table_limit) {
+  if (number > 0 && number <= table_limit) {
+    return GOLDBACH_COST_TABLE;
+  }
+  return number % 2 == 0 ? GOLDBACH_COST_STRONG : GOLDBACH_COST_WEAK;
+}
+
+double goldbach_cost_estimate(int64_t number, int64_t table_limit,
+  goldbach_kernel_t kernel) {
+  const int64_t magnitude = llabs(number);
+  if (magnitude < 6) {
+    return 1.0;
+  }
+  double cost = 1.0;
+  switch (goldbach_cost_classify(number, table_limit)) {
+    case GOLDBACH_COST_TABLE:
+      cost = magnitude % 2 ? goldbach_cost_estimate_pi(magnitude) : 1.0;
+      break;
+    case GOLDBACH_COST_STRONG:
+      cost = kernel == GOLDBACH_KERNEL_LIST
+        ? goldbach_cost_estimate_pi(magnitude / 2) : magnitude / 2.0;
+      break;
+    default:
+      if (kernel == GOLDBACH_KERNEL_LIST) {
+        const double pi = goldbach_cost_estimate_pi(magnitude);
+        cost = pi * pi / 8.0;
+      } else {
+        cost = goldbach_cost_estimate_pi(magnitude / 3) * magnitude / 4.0;
+      }
+      break;
+  }
+  return cost > 1.0 ? cost : 1.0;
+}
@@ -0,0 +1,50 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_COST_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_COST_H
+
+#include <stdint.h>
+
+#include "goldbach_options.h"
+
+/// Kinds of numbers whose work grows in a different way
+typedef enum goldbach_cost_class {
+  /// Odd numbers calculated by the kernels, quadratic in pi(n)
+  GOLDBACH_COST_WEAK,
+  /// Even numbers calculated by the kernels, linear in pi(n / 2)
+  GOLDBACH_COST_STRONG,
+  /// Positive numbers counted from the pair table
+  GOLDBACH_COST_TABLE,
+  GOLDBACH_COST_CLASS_COUNT,
+} goldbach_cost_class_t;
+
+/**
+ * @brief returns an estimation of the amount of primes up to a number.
+ * @param number the number.
+ * @return number / ln(number).
+ */
+double goldbach_cost_estimate_pi(int64_t number);
+
+/**
+ * @brief returns the kind of work of a number.
+ * @param number the number, negative if its sums are listed.
+ * @param table_limit limit of the pair table, 0 if it is not used.
+ * @return the class of the number.
+ */
+goldbach_cost_class_t goldbach_cost_classify(int64_t number,
+  int64_t table_limit);
+
+/**
+ * @brief estimates the operations needed to find the sums of a number.
+ * @details the list kernels take pi(n)^2 / 8 operations for odd numbers and
+ * pi(n / 2) for even ones, the scan kernels take pi(n / 3) * n / 4 and n / 2.
+ * Odd numbers counted from the pair table take pi(n), even ones take one.
+ * @param number the number, negative if its sums are listed.
+ * @param table_limit limit of the pair table, 0 if it is not used.
+ * @param kernel loops used to find the sums.
+ * @return the estimated amount of operations, at least one.
+ */
+double goldbach_cost_estimate(int64_t number, int64_t table_limit,
+  goldbach_kernel_t kernel);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_COST_H
@@ -0,0 +1,156 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "goldbach_deque.h"
+
+/**
+ * @brief creates an empty array of tasks.
+ * @param capacity amount of tasks, a power of two.
+ * @return the array, or NULL if it could not be allocated.
+ */
+goldbach_deque_array_t* goldbach_deque_create_array(int64_t capacity);
+
+/**
+ * @brief replaces the array of the deque by one of double capacity.
+ * @details the old array is kept until the deque is destroyed, because
+ * thieves could be reading it.
+ * @param deque pointer to the deque.
+ * @param array the current array.
+ * @param top first task in the deque.
+ * @param bottom position after the last task in the deque.
+ * @return the new array, or NULL if it could not be allocated.
+ */
+goldbach_deque_array_t* goldbach_deque_grow(goldbach_deque_t* deque,
+  goldbach_deque_array_t* array, int64_t top, int64_t bottom);
+
+int goldbach_deque_init(goldbach_deque_t* deque) {
+  assert(deque);
+  atomic_init(&deque->top, 0);
+  atomic_init(&deque->bottom, 0);
+  goldbach_deque_array_t* array = goldbach_deque_create_array(
+    GOLDBACH_DEQUE_CAPACITY);
+  atomic_init(&deque->array, array);
+  return array ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void goldbach_deque_destroy(goldbach_deque_t* deque) {
+  assert(deque);
+  goldbach_deque_array_t* array = atomic_load(&deque->array);
+  if (array) {
+    for (int64_t index = atomic_load(&deque->top);
+      index < atomic_load(&deque->bottom); ++index) {
+      free(atomic_load(&array->tasks[index & (array->capacity - 1)]));
+    }
+  }
+  while (array) {
+    goldbach_deque_array_t* previous = array->previous;
+    free(array);
+    array = previous;
+  }
+  atomic_store(&deque->array, NULL);
+}
+
+goldbach_deque_array_t* goldbach_deque_create_array(int64_t capacity) {
+  goldbach_deque_array_t* array = (goldbach_deque_array_t*) calloc(1,
+    sizeof(goldbach_deque_array_t) + capacity * sizeof(goldbach_number_t*));
+  if (array) {
+    array->capacity = capacity;
+    array->previous = NULL;
+  }
+  return array;
+}
+
+int goldbach_deque_push(goldbach_deque_t* deque, goldbach_number_t* task) {
+  assert(deque);
+  const int64_t bottom = atomic_load_explicit(&deque->bottom,
+    memory_order_relaxed);
+  const int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+  goldbach_deque_array_t* array = atomic_load_explicit(&deque->array,
+    memory_order_relaxed);
+  if (bottom - top > array->capacity - 1) {
+    array = goldbach_deque_grow(deque, array, top, bottom);
+    if (array == NULL) {
+      return EXIT_FAILURE;
+    }
+  }
+  atomic_store_explicit(&array->tasks[bottom & (array->capacity - 1)], task,
+    memory_order_relaxed);
+  // Thieves that see the new bottom see the task
+  atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+  return EXIT_SUCCESS;
+}
+
+goldbach_deque_array_t* goldbach_deque_grow(goldbach_deque_t* deque,
+  goldbach_deque_array_t* array, int64_t top, int64_t bottom) {
+  goldbach_deque_array_t* bigger = goldbach_deque_create_array(
+    2 * array->capacity);
+  if (bigger) {
+    for (int64_t index = top; index < bottom; ++index) {
+      atomic_store_explicit(&bigger->tasks[index & (bigger->capacity - 1)],
+        atomic_load_explicit(&array->tasks[index & (array->capacity - 1)],
+        memory_order_relaxed), memory_order_relaxed);
+    }
+    bigger->previous = array;
+    atomic_store_explicit(&deque->array, bigger, memory_order_release);
+  }
+  return bigger;
+}
+
+goldbach_number_t* goldbach_deque_take(goldbach_deque_t* deque) {
+  assert(deque);
+  const int64_t bottom = atomic_load_explicit(&deque->bottom,
+    memory_order_relaxed) - 1;
+  goldbach_deque_array_t* array = atomic_load_explicit(&deque->array,
+    memory_order_relaxed);
+  atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+  goldbach_number_t* task = NULL;
+  if (top <= bottom) {
+    task = atomic_load_explicit(&array->tasks[bottom & (array->capacity - 1)],
+      memory_order_relaxed);
+    if (top == bottom) {
+      // The last task, a thief could be stealing it
+      if (!atomic_compare_exchange_strong_explicit(&deque->top, &top,
+        top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+        task = NULL;
+      }
+      atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+  } else {
+    // The deque was empty
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+  }
+  return task;
+}
+
+bool goldbach_deque_is_empty(goldbach_deque_t* deque) {
+  assert(deque);
+  return atomic_load_explicit(&deque->bottom, memory_order_relaxed)
+    <= atomic_load_explicit(&deque->top, memory_order_relaxed);
+}
+
+bool goldbach_deque_steal(goldbach_deque_t* deque, goldbach_number_t** task) {
+  assert(deque);
+  assert(task);
+  *task = NULL;
+  int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  const int64_t bottom = atomic_load_explicit(&deque->bottom,
+    memory_order_acquire);
+  if (top < bottom) {
+    goldbach_deque_array_t* array = atomic_load_explicit(&deque->array,
+      memory_order_acquire);
+    goldbach_number_t* stolen = atomic_load_explicit(
+      &array->tasks[top & (array->capacity - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+      memory_order_seq_cst, memory_order_relaxed)) {
+      return false;
+    }
+    *task = stolen;
+  }
+  return true;
+}
@@ -0,0 +1,92 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_DEQUE_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_DEQUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "goldbach_number_queue.h"
+
+/// Initial amount of tasks that a deque can store, a power of two
+#define GOLDBACH_DEQUE_CAPACITY 64
+
+/**
+ * @brief circular array of the tasks of a deque.
+ */
+typedef struct goldbach_deque_array {
+  int64_t capacity;
+  /// Replaced arrays, thieves could still be reading them
+  struct goldbach_deque_array* previous;
+  _Atomic(goldbach_number_t*) tasks[];
+} goldbach_deque_array_t;
+
+/**
+ * @brief work-stealing deque of Chase and Lev.
+ * @details the owner pushes and takes tasks at the bottom without locks, and
+ * the other threads steal tasks from the top. Only a take and a steal of the
+ * last task compete with a compare-and-swap on the top. Uses the memory
+ * orders of Le, Pop, Cohen and Zappa Nardelli (2013).
+ */
+typedef struct goldbach_deque {
+  atomic_int_fast64_t top;
+  char padding_top[GOLDBACH_NUMBER_QUEUE_CACHE_LINE
+    - sizeof(atomic_int_fast64_t)];
+  atomic_int_fast64_t bottom;
+  _Atomic(goldbach_deque_array_t*) array;
+  char padding_bottom[GOLDBACH_NUMBER_QUEUE_CACHE_LINE
+    - sizeof(atomic_int_fast64_t) - sizeof(void*)];
+} goldbach_deque_t;
+
+/**
+ * @brief initialize the goldbach_deque struct.
+ * @param deque pointer to the deque to be initialized.
+ * @return an integer to check errors.
+ */
+int goldbach_deque_init(goldbach_deque_t* deque);
+
+/**
+ * @brief destroys the goldbach_deque struct.
+ * @details the tasks left in the deque are freed.
+ * @param deque pointer to the deque to be destroyed.
+ */
+void goldbach_deque_destroy(goldbach_deque_t* deque);
+
+/**
+ * @brief adds a task at the bottom of the deque.
+ * @details only called by the owner of the deque. The array is doubled when
+ * it is full.
+ * @param deque pointer to the deque.
+ * @param task the task, allocated with malloc.
+ * @return an integer to check errors.
+ */
+int goldbach_deque_push(goldbach_deque_t* deque, goldbach_number_t* task);
+
+/**
+ * @brief removes the task at the bottom of the deque.
+ * @details only called by the owner of the deque.
+ * @param deque pointer to the deque.
+ * @return the task, or NULL if the deque is empty.
+ */
+goldbach_number_t* goldbach_deque_take(goldbach_deque_t* deque);
+
+/**
+ * @brief returns if the deque has no tasks.
+ * @details the answer can be outdated when other threads steal from it.
+ * @param deque pointer to the deque.
+ * @return true if there are no tasks.
+ */
+bool goldbach_deque_is_empty(goldbach_deque_t* deque);
+
+/**
+ * @brief removes the task at the top of the deque.
+ * @details called by any thread.
+ * @param deque pointer to the deque.
+ * @param task where the task is stored, NULL if there is not a task.
+ * @return false if other thread took the task first and it should be tried
+ * again.
+ */
+bool goldbach_deque_steal(goldbach_deque_t* deque, goldbach_number_t** task);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_DEQUE_H
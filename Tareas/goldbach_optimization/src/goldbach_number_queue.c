@@ -2,100 +2,183 @@
 // Implements a thread-safe queue
 
 #include <assert.h>
+#include <sched.h>
 #include <stdlib.h>
 
 #include "goldbach_number_queue.h"
 
-void goldbach_number_queue_remove_first_unsafe(goldbach_number_queue_t* queue);
-bool goldbach_number_queue_is_empty_unsafe(const
-  goldbach_number_queue_t* queue);
-
-int goldbach_number_queue_init(goldbach_number_queue_t* queue) {
+/**
+ * @brief wakes the threads sleeping on one side of the queue up.
+ * @details called after an operation of the other side. The fence orders the
+ * operation before the load of the waiting count, and a sleeping thread
+ * checks the queue again after increasing it, so a wake up is never lost.
+ * @param queue pointer to the queue.
+ * @param waiting waiting count of the side to be woken up.
+ * @param condition condition where that side sleeps.
+ */
+void goldbach_number_queue_wake(goldbach_number_queue_t* queue,
+  atomic_int* waiting, pthread_cond_t* condition);
+
+int goldbach_number_queue_init(goldbach_number_queue_t* queue,
+  size_t capacity) {
   assert(queue);
-  queue->head = NULL;
-  queue->tail = NULL;
-  return pthread_mutex_init(&queue->can_access_queue, NULL);
+  size_t slot_count = 2;
+  while (slot_count < capacity) {
+    slot_count *= 2;
+  }
+  queue->slots = (goldbach_number_queue_slot_t*) aligned_alloc(
+    GOLDBACH_NUMBER_QUEUE_CACHE_LINE,
+    slot_count * sizeof(goldbach_number_queue_slot_t));
+  if (queue->slots == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (size_t index = 0; index < slot_count; ++index) {
+    atomic_init(&queue->slots[index].sequence, index);
+  }
+  queue->mask = slot_count - 1;
+  atomic_init(&queue->enqueue_position, 0);
+  atomic_init(&queue->dequeue_position, 0);
+  atomic_init(&queue->enqueue_waiting, 0);
+  atomic_init(&queue->dequeue_waiting, 0);
+  int error = pthread_mutex_init(&queue->can_access_waiting, NULL);
+  error = error ? error : pthread_cond_init(&queue->can_enqueue, NULL);
+  error = error ? error : pthread_cond_init(&queue->can_dequeue, NULL);
+  return error;
 }
 
 int goldbach_number_queue_destroy(goldbach_number_queue_t* queue) {
-  goldbach_number_queue_clear(queue);
-  return pthread_mutex_destroy(&queue->can_access_queue);
-}
-
-bool goldbach_number_queue_is_empty_unsafe(const
-  goldbach_number_queue_t* queue) {
   assert(queue);
-  return queue->head == NULL;
+  free(queue->slots);
+  queue->slots = NULL;
+  pthread_cond_destroy(&queue->can_enqueue);
+  pthread_cond_destroy(&queue->can_dequeue);
+  return pthread_mutex_destroy(&queue->can_access_waiting);
 }
 
-bool goldbach_number_queue_is_empty(goldbach_number_queue_t* queue) {
-  assert(queue);
-  pthread_mutex_lock(&queue->can_access_queue);
-  bool result = goldbach_number_queue_is_empty_unsafe(queue);
-  pthread_mutex_unlock(&queue->can_access_queue);
-  return result;
-}
-
-int goldbach_number_queue_enqueue(goldbach_number_queue_t* queue,
+bool goldbach_number_queue_try_enqueue(goldbach_number_queue_t* queue,
   const goldbach_number_t data) {
   assert(queue);
-  int error = EXIT_SUCCESS;
-
-  goldbach_number_queue_node_t* new_node = (goldbach_number_queue_node_t*)
-    calloc(1, sizeof(goldbach_number_queue_node_t));
-
-  if (new_node) {
-    new_node->data = data;
-
-    pthread_mutex_lock(&queue->can_access_queue);
-    if (queue->tail) {
-      queue->tail = queue->tail->next = new_node;
+  size_t position = atomic_load_explicit(&queue->enqueue_position,
+    memory_order_relaxed);
+  goldbach_number_queue_slot_t* slot = NULL;
+  while (true) {
+    slot = &queue->slots[position & queue->mask];
+    const size_t sequence = atomic_load_explicit(&slot->sequence,
+      memory_order_acquire);
+    const intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+    if (difference == 0) {
+      // The slot is free in this round, claim the position
+      if (atomic_compare_exchange_weak_explicit(&queue->enqueue_position,
+        &position, position + 1, memory_order_relaxed,
+        memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // The slot was not dequeued in the previous round, the queue is full
+      return false;
     } else {
-      queue->head = queue->tail = new_node;
+      // Other producer claimed the position
+      position = atomic_load_explicit(&queue->enqueue_position,
+        memory_order_relaxed);
     }
-    pthread_mutex_unlock(&queue->can_access_queue);
-  } else {
-    error = EXIT_FAILURE;
   }
-
-  return error;
+  slot->data = data;
+  atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+  return true;
 }
 
-int goldbach_number_queue_dequeue(goldbach_number_queue_t* queue,
+bool goldbach_number_queue_try_dequeue(goldbach_number_queue_t* queue,
   goldbach_number_t* data) {
   assert(queue);
-  int error = 0;
-
-  pthread_mutex_lock(&queue->can_access_queue);
-    if (!goldbach_number_queue_is_empty_unsafe(queue)) {
-      if (data) {
-        *data = queue->head->data;
+  size_t position = atomic_load_explicit(&queue->dequeue_position,
+    memory_order_relaxed);
+  goldbach_number_queue_slot_t* slot = NULL;
+  while (true) {
+    slot = &queue->slots[position & queue->mask];
+    const size_t sequence = atomic_load_explicit(&slot->sequence,
+      memory_order_acquire);
+    const intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+    if (difference == 0) {
+      // The slot was written in this round, claim the position
+      if (atomic_compare_exchange_weak_explicit(&queue->dequeue_position,
+        &position, position + 1, memory_order_relaxed,
+        memory_order_relaxed)) {
+        break;
       }
-      goldbach_number_queue_remove_first_unsafe(queue);
+    } else if (difference < 0) {
+      // The slot was not written yet, the queue is empty
+      return false;
     } else {
-      error = EXIT_FAILURE;
+      // Other consumer claimed the position
+      position = atomic_load_explicit(&queue->dequeue_position,
+        memory_order_relaxed);
     }
-  pthread_mutex_unlock(&queue->can_access_queue);
-
-  return error;
+  }
+  if (data) {
+    *data = slot->data;
+  }
+  // The slot is free for the producer of the next round
+  atomic_store_explicit(&slot->sequence, position + queue->mask + 1,
+    memory_order_release);
+  return true;
 }
 
-void goldbach_number_queue_remove_first_unsafe(goldbach_number_queue_t* queue) {
+int goldbach_number_queue_enqueue(goldbach_number_queue_t* queue,
+  const goldbach_number_t data) {
   assert(queue);
-  assert(!goldbach_number_queue_is_empty_unsafe(queue));
-  goldbach_number_queue_node_t* node = queue->head;
-  queue->head = queue->head->next;
-  free(node);
-  if (queue->head == NULL) {
-    queue->tail = NULL;
+  bool enqueued = goldbach_number_queue_try_enqueue(queue, data);
+  for (int attempt = 0; !enqueued && attempt < GOLDBACH_NUMBER_QUEUE_SPIN_COUNT;
+    ++attempt) {
+    sched_yield();
+    enqueued = goldbach_number_queue_try_enqueue(queue, data);
   }
+  if (!enqueued) {
+    // Sleep until a consumer frees a slot
+    pthread_mutex_lock(&queue->can_access_waiting);
+    atomic_fetch_add(&queue->enqueue_waiting, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    while (!goldbach_number_queue_try_enqueue(queue, data)) {
+      pthread_cond_wait(&queue->can_enqueue, &queue->can_access_waiting);
+    }
+    atomic_fetch_sub(&queue->enqueue_waiting, 1);
+    pthread_mutex_unlock(&queue->can_access_waiting);
+  }
+  goldbach_number_queue_wake(queue, &queue->dequeue_waiting,
+    &queue->can_dequeue);
+  return EXIT_SUCCESS;
 }
 
-void goldbach_number_queue_clear(goldbach_number_queue_t* queue) {
+int goldbach_number_queue_dequeue(goldbach_number_queue_t* queue,
+  goldbach_number_t* data) {
   assert(queue);
-  pthread_mutex_lock(&queue->can_access_queue);
-    while (!goldbach_number_queue_is_empty_unsafe(queue)) {
-      goldbach_number_queue_remove_first_unsafe(queue);
+  bool dequeued = goldbach_number_queue_try_dequeue(queue, data);
+  for (int attempt = 0; !dequeued && attempt < GOLDBACH_NUMBER_QUEUE_SPIN_COUNT;
+    ++attempt) {
+    sched_yield();
+    dequeued = goldbach_number_queue_try_dequeue(queue, data);
+  }
+  if (!dequeued) {
+    // Sleep until a producer writes a slot
+    pthread_mutex_lock(&queue->can_access_waiting);
+    atomic_fetch_add(&queue->dequeue_waiting, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    while (!goldbach_number_queue_try_dequeue(queue, data)) {
+      pthread_cond_wait(&queue->can_dequeue, &queue->can_access_waiting);
     }
-  pthread_mutex_unlock(&queue->can_access_queue);
+    atomic_fetch_sub(&queue->dequeue_waiting, 1);
+    pthread_mutex_unlock(&queue->can_access_waiting);
+  }
+  goldbach_number_queue_wake(queue, &queue->enqueue_waiting,
+    &queue->can_enqueue);
+  return EXIT_SUCCESS;
+}
+
+void goldbach_number_queue_wake(goldbach_number_queue_t* queue,
+  atomic_int* waiting, pthread_cond_t* condition) {
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(waiting, memory_order_relaxed) > 0) {
+    pthread_mutex_lock(&queue->can_access_waiting);
+    pthread_cond_broadcast(condition);
+    pthread_mutex_unlock(&queue->can_access_waiting);
+  }
 }
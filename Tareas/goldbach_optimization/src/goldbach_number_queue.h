@@ -5,37 +5,123 @@
 #define GOLDBACH_NUMBER_QUEUE_H
 
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Bytes of a cache line, hot fields of different threads are kept apart
+#define GOLDBACH_NUMBER_QUEUE_CACHE_LINE 64
+/// Default amount of slots of the queue, must be a power of two
+#define GOLDBACH_NUMBER_QUEUE_CAPACITY 1024
+/// Failed attempts before a thread blocks on a full or empty queue
+#define GOLDBACH_NUMBER_QUEUE_SPIN_COUNT 64
 
 typedef struct  {
   int64_t number;
   int64_t index;
+  /// Range of smallest addends of the sums calculated by this unit
+  int64_t start;
+  int64_t finish;
+  /// Position of the unit in the schedule of a batch
+  int64_t position;
+  /// Units at the next positions of the schedule handed out with this one
+  int64_t batch_count;
 } goldbach_number_t;
 
-typedef struct goldbach_number_queue_node {
+/**
+ * @brief a slot of the ring, padded to fill a cache line.
+ * @details the sequence tells the round of the slot: it is equal to the
+ * position of the enqueue that can write it, and to that position plus one
+ * when the data can be dequeued.
+ */
+typedef struct {
+  atomic_size_t sequence;
   goldbach_number_t data;
-  struct goldbach_number_queue_node* next;
-} goldbach_number_queue_node_t;
+  char padding[GOLDBACH_NUMBER_QUEUE_CACHE_LINE - sizeof(atomic_size_t)
+    - sizeof(goldbach_number_t)];
+} goldbach_number_queue_slot_t;
 
+/**
+ * @brief bounded multi-producer multi-consumer queue without locks.
+ * @details producers and consumers claim positions of a ring of slots with a
+ * compare-and-swap (Vyukov's bounded queue). A thread only takes the mutex
+ * to sleep when the queue stays full or empty, and the other side only takes
+ * it to wake sleeping threads up.
+ */
 typedef struct {
-  pthread_mutex_t can_access_queue;
-  goldbach_number_queue_node_t* head;
-  goldbach_number_queue_node_t* tail;
+  goldbach_number_queue_slot_t* slots;
+  size_t mask;
+  char padding_slots[GOLDBACH_NUMBER_QUEUE_CACHE_LINE - sizeof(void*)
+    - sizeof(size_t)];
+  /// Next position to be written by a producer
+  atomic_size_t enqueue_position;
+  char padding_enqueue[GOLDBACH_NUMBER_QUEUE_CACHE_LINE
+    - sizeof(atomic_size_t)];
+  /// Next position to be read by a consumer
+  atomic_size_t dequeue_position;
+  char padding_dequeue[GOLDBACH_NUMBER_QUEUE_CACHE_LINE
+    - sizeof(atomic_size_t)];
+  /// Threads sleeping because the queue is full or empty
+  atomic_int enqueue_waiting;
+  atomic_int dequeue_waiting;
+  pthread_mutex_t can_access_waiting;
+  pthread_cond_t can_enqueue;
+  pthread_cond_t can_dequeue;
 } goldbach_number_queue_t;
 
 /**
- * ...
+ * @brief initialize the queue.
+ * @param queue pointer to the queue to be initialized.
+ * @param capacity amount of slots, it is rounded up to a power of two.
+ * @return an integer to check errors.
  * @remaks This subroutine is NOT thread-safe
  */
-int goldbach_number_queue_init(goldbach_number_queue_t* queue);
+int goldbach_number_queue_init(goldbach_number_queue_t* queue,
+  size_t capacity);
 
+/**
+ * @brief destroys the queue, the data that was not dequeued is discarded.
+ * @param queue pointer to the queue to be destroyed.
+ * @return an integer to check errors.
+ * @remaks This subroutine is NOT thread-safe
+ */
 int goldbach_number_queue_destroy(goldbach_number_queue_t* queue);
 
-bool goldbach_number_queue_is_empty(goldbach_number_queue_t* queue);
+/**
+ * @brief adds data at the end of the queue if it is not full.
+ * @param queue pointer to the queue.
+ * @param data the data.
+ * @return true if the data was added.
+ */
+bool goldbach_number_queue_try_enqueue(goldbach_number_queue_t* queue,
+  const goldbach_number_t data);
+
+/**
+ * @brief removes the data at the start of the queue if it is not empty.
+ * @param queue pointer to the queue.
+ * @param data where the data is stored.
+ * @return true if the data was removed.
+ */
+bool goldbach_number_queue_try_dequeue(goldbach_number_queue_t* queue,
+  goldbach_number_t* data);
+
+/**
+ * @brief adds data at the end of the queue, waits while it is full.
+ * @param queue pointer to the queue.
+ * @param data the data.
+ * @return an integer to check errors.
+ */
 int goldbach_number_queue_enqueue(goldbach_number_queue_t* queue,
   const goldbach_number_t data);
+
+/**
+ * @brief removes the data at the start of the queue, waits while it is empty.
+ * @param queue pointer to the queue.
+ * @param data where the data is stored.
+ * @return an integer to check errors.
+ */
 int goldbach_number_queue_dequeue(goldbach_number_queue_t* queue,
   goldbach_number_t* data);
-void goldbach_number_queue_clear(goldbach_number_queue_t* queue);
 
 #endif  // GOLDBACH_NUMBER_QUEUE_H
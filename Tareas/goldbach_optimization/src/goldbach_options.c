@@ -0,0 +1,126 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cpu_topology.h"
+#include "goldbach_options.h"
+#include "goldbach_reorder_buffer.h"
+
+/**
+ * @brief returns the value of an option if the argument is that option.
+ * @param argument argument given in console.
+ * @param name name of the option, including the dashes and the equal sign.
+ * @return the text after the equal sign, or NULL if it is other option.
+ */
+const char* goldbach_options_value(const char* argument, const char* name);
+
+int goldbach_options_parse(goldbach_options_t* options, int argc,
+  char* argv[]) {
+  assert(options);
+  int error = EXIT_SUCCESS;
+  options->thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+  options->kernel = GOLDBACH_KERNEL_LIST;
+  options->schedule = GOLDBACH_SCHEDULE_CURSOR;
+  options->chunk_size = 0;
+  options->order = GOLDBACH_ORDER_COST;
+  options->cost_report = false;
+  options->stream = false;
+  options->window = GOLDBACH_REORDER_BUFFER_WINDOW;
+  options->affinity = GOLDBACH_AFFINITY_NONE;
+  options->avoid_smt = false;
+  options->prealloc = false;
+  bool has_thread_count = false;
+
+  for (int index = 1; index < argc && error == EXIT_SUCCESS; ++index) {
+    const char* value = NULL;
+    if ((value = goldbach_options_value(argv[index], "--kernel="))) {
+      if (strcmp(value, "list") == 0) {
+        options->kernel = GOLDBACH_KERNEL_LIST;
+      } else if (strcmp(value, "scan") == 0) {
+        options->kernel = GOLDBACH_KERNEL_SCAN;
+      } else {
+        fprintf(stderr, "error: invalid kernel %s\n", value);
+        error = 2;
+      }
+    } else if ((value = goldbach_options_value(argv[index], "--schedule="))) {
+      if (strcmp(value, "cursor") == 0) {
+        options->schedule = GOLDBACH_SCHEDULE_CURSOR;
+      } else if (strcmp(value, "queue") == 0) {
+        options->schedule = GOLDBACH_SCHEDULE_QUEUE;
+      } else if (strcmp(value, "steal") == 0) {
+        options->schedule = GOLDBACH_SCHEDULE_STEAL;
+      } else {
+        fprintf(stderr, "error: invalid schedule %s\n", value);
+        error = 3;
+      }
+    } else if ((value = goldbach_options_value(argv[index], "--chunk="))) {
+      errno = 0;
+      if (strcmp(value, "auto") == 0) {
+        options->chunk_size = 0;
+      } else if (sscanf(value, "%" SCNd64, &options->chunk_size) != 1 || errno
+        || options->chunk_size <= 0) {
+        fprintf(stderr, "error: invalid chunk size %s\n", value);
+        error = 4;
+      }
+    } else if ((value = goldbach_options_value(argv[index], "--order="))) {
+      if (strcmp(value, "cost") == 0) {
+        options->order = GOLDBACH_ORDER_COST;
+      } else if (strcmp(value, "input") == 0) {
+        options->order = GOLDBACH_ORDER_INPUT;
+      } else {
+        fprintf(stderr, "error: invalid order %s\n", value);
+        error = 5;
+      }
+    } else if ((value = goldbach_options_value(argv[index], "--window="))) {
+      errno = 0;
+      if (sscanf(value, "%" SCNd64, &options->window) != 1 || errno
+        || options->window <= 0) {
+        fprintf(stderr, "error: invalid window %s\n", value);
+        error = 6;
+      }
+    } else if ((value = goldbach_options_value(argv[index], "--affinity="))) {
+      if (strcmp(value, "none") == 0) {
+        options->affinity = GOLDBACH_AFFINITY_NONE;
+      } else if (strcmp(value, "compact") == 0) {
+        options->affinity = GOLDBACH_AFFINITY_COMPACT;
+      } else if (strcmp(value, "scatter") == 0) {
+        options->affinity = GOLDBACH_AFFINITY_SCATTER;
+      } else {
+        fprintf(stderr, "error: invalid affinity %s\n", value);
+        error = 7;
+      }
+    } else if (strcmp(argv[index], "--no-smt") == 0) {
+      options->avoid_smt = true;
+    } else if (strcmp(argv[index], "--prealloc") == 0) {
+      options->prealloc = true;
+    } else if (strcmp(argv[index], "--cost-report") == 0) {
+      options->cost_report = true;
+    } else if (strcmp(argv[index], "--stream") == 0) {
+      options->stream = true;
+    } else {
+      errno = 0;
+      if (sscanf(argv[index], "%" SCNd64, &options->thread_count) != 1
+        || errno || options->thread_count <= 0) {
+        fprintf(stderr, "error: invalid thread count\n");
+        error = 1;
+      }
+      has_thread_count = true;
+    }
+  }
+  // Compute-bound kernels do not gain from a second thread in a core
+  if (options->avoid_smt && !has_thread_count) {
+    options->thread_count = cpu_topology_count_cores();
+  }
+  return error;
+}
+
+const char* goldbach_options_value(const char* argument, const char* name) {
+  const size_t length = strlen(name);
+  return strncmp(argument, name, length) == 0 ? argument + length : NULL;
+}
@@ -0,0 +1,90 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_OPTIONS_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_OPTIONS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Loops used to find the goldbach sums of a number
+typedef enum goldbach_kernel {
+  /// Iterates the primes of the table and looks the last addend up
+  GOLDBACH_KERNEL_LIST,
+  /// Walks every integer addend and looks every addend up
+  GOLDBACH_KERNEL_SCAN,
+} goldbach_kernel_t;
+
+/// How the consumers get the units to be calculated
+typedef enum goldbach_schedule {
+  /// Consumers claim chunks of units with an atomic cursor, no producer
+  GOLDBACH_SCHEDULE_CURSOR,
+  /// A producer thread enqueues the units for the consumers
+  GOLDBACH_SCHEDULE_QUEUE,
+  /// Every consumer has a deque of tasks, idle consumers steal and split them
+  GOLDBACH_SCHEDULE_STEAL,
+} goldbach_schedule_t;
+
+/// Order in which the units are handed out to the consumers
+typedef enum goldbach_order {
+  /// Longest processing time first, by the estimated cost of the units
+  GOLDBACH_ORDER_COST,
+  /// Same order than the numbers of the input
+  GOLDBACH_ORDER_INPUT,
+} goldbach_order_t;
+
+/// Processors where the consumers are pinned
+typedef enum goldbach_affinity {
+  /// The operating system places and migrates the threads
+  GOLDBACH_AFFINITY_NONE,
+  /// Fills the cores of a NUMA node before the next node
+  GOLDBACH_AFFINITY_COMPACT,
+  /// Spreads the consumers among the nodes and the cores
+  GOLDBACH_AFFINITY_SCATTER,
+} goldbach_affinity_t;
+
+typedef struct goldbach_options {
+  int64_t thread_count;
+  goldbach_kernel_t kernel;
+  goldbach_schedule_t schedule;
+  /// Units claimed at once by a consumer with the cursor schedule, or
+  /// enqueued at once by the producer, 0 to adapt them to the runtimes
+  int64_t chunk_size;
+  goldbach_order_t order;
+  /// Print the estimated and the actual cost of every number in stderr
+  bool cost_report;
+  /// Calculate and print the numbers while the input is being read
+  bool stream;
+  /// Numbers that can be handed out ahead of the printed ones
+  int64_t window;
+  goldbach_affinity_t affinity;
+  /// Place at most one consumer in every physical core
+  bool avoid_smt;
+  /// Count the sums of a unit before storing them in one exact allocation
+  bool prealloc;
+} goldbach_options_t;
+
+/**
+ * @brief reads the options given in console.
+ * @details the usage is: [thread_count] [--kernel=list|scan]
+ * [--schedule=cursor|queue|steal] [--chunk=auto|units] [--order=cost|input]
+ * [--cost-report] [--stream] [--window=numbers]
+ * [--affinity=none|compact|scatter] [--no-smt] [--prealloc]. Options that are
+ * not given keep their default values, the thread count defaults to the amount
+ * of processors, or of physical cores with --no-smt. With --no-smt and no
+ * affinity the consumers are pinned in compact order. With --stream the units
+ * are handed out through the queue in the order of the input, so the schedule,
+ * the order and the cost report do not apply, and the pair table grows when
+ * the positive numbers of a window pay for it. The window limits the results
+ * kept in memory with every schedule: the numbers of the batch are handed out
+ * in windows of that many numbers of the input, and --order=cost sorts the
+ * units within every window. With --prealloc the sums of a negative number
+ * are counted before they are stored, when the kernel can count them.
+ * @param options pointer to the options to be filled.
+ * @param argc amount of arguments given in console.
+ * @param argv arguments given in console.
+ * @return an integer to check errors.
+ */
+int goldbach_options_parse(goldbach_options_t* options, int argc,
+  char* argv[]);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_OPTIONS_H
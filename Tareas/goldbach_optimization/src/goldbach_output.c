@@ -0,0 +1,88 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "goldbach_output.h"
+
+int goldbach_output_init(goldbach_output_t* output, int file) {
+  assert(output);
+  output->file = file;
+  output->count = 0;
+  output->has_failed = false;
+  output->bytes = (char*) malloc(GOLDBACH_OUTPUT_CAPACITY);
+  return output->bytes ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void goldbach_output_destroy(goldbach_output_t* output) {
+  assert(output);
+  free(output->bytes);
+  output->bytes = NULL;
+  output->count = 0;
+}
+
+int goldbach_output_flush(goldbach_output_t* output) {
+  assert(output);
+  size_t written = 0;
+  while (written < output->count && !output->has_failed) {
+    const ssize_t result = write(output->file, output->bytes + written,
+      output->count - written);
+    if (result >= 0) {
+      written += (size_t)result;
+    } else if (errno != EINTR) {
+      output->has_failed = true;
+    }
+  }
+  output->count = 0;
+  return output->has_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+void goldbach_output_append(goldbach_output_t* output, const char* text,
+  size_t length) {
+  assert(output);
+  assert(text);
+  while (length > 0) {
+    if (output->count == GOLDBACH_OUTPUT_CAPACITY) {
+      goldbach_output_flush(output);
+    }
+    size_t room = GOLDBACH_OUTPUT_CAPACITY - output->count;
+    room = room < length ? room : length;
+    memcpy(output->bytes + output->count, text, room);
+    output->count += room;
+    text += room;
+    length -= room;
+  }
+}
+
+void goldbach_output_append_int64(goldbach_output_t* output, int64_t value) {
+  assert(output);
+  if (output->count + GOLDBACH_OUTPUT_INT64_DIGITS > GOLDBACH_OUTPUT_CAPACITY) {
+    goldbach_output_flush(output);
+  }
+  output->count += goldbach_output_format_int64(output->bytes + output->count,
+    value);
+}
+
+size_t goldbach_output_format_int64(char* bytes, int64_t value) {
+  assert(bytes);
+  // The magnitude of INT64_MIN does not fit in an int64_t
+  uint64_t magnitude = value < 0 ? -(uint64_t)value : (uint64_t)value;
+  char digits[GOLDBACH_OUTPUT_INT64_DIGITS];
+  size_t digit_count = 0;
+  do {
+    digits[digit_count++] = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+
+  size_t length = 0;
+  if (value < 0) {
+    bytes[length++] = '-';
+  }
+  while (digit_count > 0) {
+    bytes[length++] = digits[--digit_count];
+  }
+  return length;
+}
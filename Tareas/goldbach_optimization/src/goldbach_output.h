@@ -0,0 +1,79 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_OUTPUT_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_OUTPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Bytes of text kept before they are written to the file
+#define GOLDBACH_OUTPUT_CAPACITY (1 << 20)
+/// Most bytes of an int64_t in decimal, including the sign
+#define GOLDBACH_OUTPUT_INT64_DIGITS 20
+
+/**
+ * @brief text that is written to a file descriptor in big blocks.
+ * @details integers are converted to decimal digits by hand, without
+ * printf, and the text is written with write() when the buffer is full or
+ * flushed. Used by a single thread.
+ */
+typedef struct goldbach_output {
+  /// File descriptor where the text is written
+  int file;
+  char* bytes;
+  /// Bytes of the buffer that are not written yet
+  size_t count;
+  /// A write failed, the rest of the text is discarded
+  bool has_failed;
+} goldbach_output_t;
+
+/**
+ * @brief initialize the goldbach_output struct.
+ * @param output pointer to the output to be initialized.
+ * @param file file descriptor where the text is written.
+ * @return an integer to check errors.
+ */
+int goldbach_output_init(goldbach_output_t* output, int file);
+
+/**
+ * @brief destroys the goldbach_output struct.
+ * @details the text must be flushed before.
+ * @param output pointer to the output to be destroyed.
+ */
+void goldbach_output_destroy(goldbach_output_t* output);
+
+/**
+ * @brief writes the text of the buffer to the file.
+ * @details writes again after partial writes and interruptions.
+ * @param output pointer to the output.
+ * @return an integer to check errors.
+ */
+int goldbach_output_flush(goldbach_output_t* output);
+
+/**
+ * @brief appends text to the buffer.
+ * @param output pointer to the output.
+ * @param text the text.
+ * @param length bytes of the text.
+ */
+void goldbach_output_append(goldbach_output_t* output, const char* text,
+  size_t length);
+
+/**
+ * @brief writes an integer in decimal.
+ * @param bytes where the digits are written, with room for
+ * GOLDBACH_OUTPUT_INT64_DIGITS bytes.
+ * @param value the integer.
+ * @return the amount of bytes written.
+ */
+size_t goldbach_output_format_int64(char* bytes, int64_t value);
+
+/**
+ * @brief appends an integer in decimal to the buffer.
+ * @param output pointer to the output.
+ * @param value the integer.
+ */
+void goldbach_output_append_int64(goldbach_output_t* output, int64_t value);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_OUTPUT_H
@@ -0,0 +1,207 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "goldbach_cost.h"
+#include "goldbach_pair_table.h"
+
+/**
+ * @brief counts the pairs of the even numbers of one chunk of the table.
+ * @details for every odd prime q the primes r >= q in the range of the chunk
+ * are taken from the words of the table of primes.
+ * @param table pointer to the table.
+ * @param primes table of primes that covers the limit of the table.
+ * @param chunk the chunk to be filled.
+ */
+void goldbach_pair_table_fill_chunk(goldbach_pair_table_t* table,
+  const prime_table_t* primes, int64_t chunk);
+
+int64_t goldbach_pair_table_choose_limit(array_int64_t* numbers) {
+  assert(numbers);
+  int64_t limit = 0;
+  double direct_cost = 0.0;
+  for (int64_t index = 0; index < array_int64_getCount(numbers); ++index) {
+    // Only positive numbers are counted, the negative ones are listed
+    const int64_t number = array_int64_getElement(numbers, index);
+    if (number > 5 && number <= GOLDBACH_PAIR_TABLE_MAX_LIMIT) {
+      direct_cost += goldbach_pair_table_estimate_direct(number);
+      if (number > limit) {
+        limit = number;
+      }
+    }
+  }
+  return direct_cost > goldbach_pair_table_estimate_fill(limit) ? limit : 0;
+}
+
+double goldbach_pair_table_estimate_direct(int64_t number) {
+  if (number % 2 == 0) {
+    return goldbach_cost_estimate_pi(number / 2);
+  }
+  const double pi = goldbach_cost_estimate_pi(number);
+  return pi * pi / 8.0;
+}
+
+double goldbach_pair_table_estimate_fill(int64_t limit) {
+  // Pairs of primes up to the limit, plus the words scanned for every prime
+  const double pi = goldbach_cost_estimate_pi(limit);
+  return pi * pi / 4.0
+    + goldbach_cost_estimate_pi(limit / 2) * (double)limit / 128.0;
+}
+
+int goldbach_pair_table_init(goldbach_pair_table_t* table, int64_t limit) {
+  assert(table);
+  table->limit = limit;
+  table->pair_counts = NULL;
+  table->chunk_count = 0;
+  atomic_init(&table->next_chunk, 0);
+  atomic_init(&table->filled_count, 0);
+  if (limit > 0) {
+    table->pair_counts = (uint32_t*) calloc((size_t)limit / 2 + 1,
+      sizeof(uint32_t));
+    if (table->pair_counts == NULL) {
+      table->limit = 0;
+      return EXIT_FAILURE;
+    }
+    table->chunk_count = limit / GOLDBACH_PAIR_TABLE_CHUNK_NUMBERS + 1;
+  }
+  return EXIT_SUCCESS;
+}
+
+int goldbach_pair_table_grow(goldbach_pair_table_t* table, int64_t limit) {
+  assert(table);
+  assert(limit > table->limit);
+  uint32_t* pair_counts = (uint32_t*) calloc((size_t)limit / 2 + 1,
+    sizeof(uint32_t));
+  if (pair_counts == NULL) {
+    return EXIT_FAILURE;
+  }
+  // The last chunk of a filled table can end before the chunk size
+  int64_t kept_count = 0;
+  if (atomic_load(&table->filled_count) == table->chunk_count) {
+    kept_count = (table->limit + 1) / GOLDBACH_PAIR_TABLE_CHUNK_NUMBERS;
+  }
+  if (kept_count > 0) {
+    memcpy(pair_counts, table->pair_counts, (size_t)(kept_count
+      * GOLDBACH_PAIR_TABLE_CHUNK_NUMBERS / 2) * sizeof(uint32_t));
+  }
+
+  free(table->pair_counts);
+  table->pair_counts = pair_counts;
+  table->limit = limit;
+  table->chunk_count = limit / GOLDBACH_PAIR_TABLE_CHUNK_NUMBERS + 1;
+  atomic_store(&table->next_chunk, kept_count);
+  atomic_store(&table->filled_count, kept_count);
+  return EXIT_SUCCESS;
+}
+
+void goldbach_pair_table_destroy(goldbach_pair_table_t* table) {
+  assert(table);
+  free(table->pair_counts);
+  table->pair_counts = NULL;
+  table->limit = 0;
+  table->chunk_count = 0;
+}
+
+void goldbach_pair_table_require(goldbach_pair_table_t* table,
+  const prime_table_t* primes) {
+  assert(table);
+  assert(primes->limit >= table->limit);
+  while (atomic_load_explicit(&table->filled_count, memory_order_acquire)
+    < table->chunk_count) {
+    const int64_t chunk = atomic_fetch_add(&table->next_chunk, 1);
+    if (chunk < table->chunk_count) {
+      goldbach_pair_table_fill_chunk(table, primes, chunk);
+      atomic_fetch_add_explicit(&table->filled_count, 1,
+        memory_order_release);
+    } else {
+      // Other threads are filling the chunks that are missing
+      sched_yield();
+    }
+  }
+}
+
+void goldbach_pair_table_fill_chunk(goldbach_pair_table_t* table,
+  const prime_table_t* primes, int64_t chunk) {
+  // Even numbers of the chunk are in [start, finish)
+  const int64_t start = chunk * GOLDBACH_PAIR_TABLE_CHUNK_NUMBERS;
+  int64_t finish = start + GOLDBACH_PAIR_TABLE_CHUNK_NUMBERS;
+  if (finish > table->limit + 1) {
+    finish = table->limit + 1;
+  }
+  // 2 is not part of any pair of an even number
+  const int64_t first_last_bit = prime_table_last_bit((finish - 1) / 2);
+  for (int64_t first_index = 0; first_index <= first_last_bit
+    / PRIME_TABLE_WORD_BITS; ++first_index) {
+    uint64_t first_word = prime_table_get_word(primes, first_index,
+      prime_table_first_bit(3), first_last_bit);
+    while (first_word) {
+      const int64_t first = 2 * (first_index * PRIME_TABLE_WORD_BITS
+        + __builtin_ctzll(first_word)) + 1;
+      // The second addend is odd, in [first, finish - first) and
+      // >= start - first
+      const int64_t lowest = start - first > first ? start - first : first;
+      const int64_t first_bit = lowest >> 1;
+      const int64_t last_bit = prime_table_last_bit(finish - first - 1);
+      for (int64_t word_index = first_bit / PRIME_TABLE_WORD_BITS;
+        word_index <= last_bit / PRIME_TABLE_WORD_BITS; ++word_index) {
+        uint64_t word = prime_table_get_word(primes, word_index, first_bit,
+          last_bit);
+        while (word) {
+          const int64_t second = 2 * (word_index * PRIME_TABLE_WORD_BITS
+            + __builtin_ctzll(word)) + 1;
+          ++table->pair_counts[(first + second) / 2];
+          word &= word - 1;
+        }
+      }
+      first_word &= first_word - 1;
+    }
+  }
+}
+
+int64_t goldbach_pair_table_count_strong(const goldbach_pair_table_t* table,
+  int64_t number) {
+  assert(number <= table->limit);
+  return table->pair_counts[number / 2];
+}
+
+int64_t goldbach_pair_table_count_weak(const goldbach_pair_table_t* table,
+  const prime_table_t* primes, int64_t number) {
+  assert(number <= table->limit);
+  // Ordered triples of odd primes, and the ones with a repeated addend
+  int64_t ordered_count = 0;
+  int64_t repeated_count = 0;
+
+  for (int64_t word_index = 0; word_index < primes->word_count;
+    ++word_index) {
+    uint64_t word = primes->words[word_index];
+    const int64_t word_start = word_index * PRIME_TABLE_WORD_BITS;
+    // The rest of the number must be at least 3 + 3
+    if (2 * word_start + 1 > number - 6) {
+      break;
+    }
+    while (word) {
+      const int64_t prime = 2 * (word_start + __builtin_ctzll(word)) + 1;
+      if (prime > number - 6) {
+        break;
+      }
+      const int64_t rest = number - prime;
+      // Ordered pairs are the sorted pairs twice, except the rest / 2 twins
+      ordered_count += 2 * (int64_t)table->pair_counts[rest / 2]
+        - prime_table_is_prime(primes, rest / 2) * ((rest / 2) % 2);
+      // Triples prime + prime + (number - 2 * prime)
+      if (2 * prime < number) {
+        repeated_count += prime_table_is_prime(primes, number - 2 * prime);
+      }
+      word &= word - 1;
+    }
+  }
+
+  // Burnside's lemma on the permutations of the three addends
+  const int64_t equal_count = number % 3 == 0
+    && prime_table_is_prime(primes, number / 3);
+  return prime_table_is_prime(primes, number - 4)
+    + (ordered_count + 3 * repeated_count + 2 * equal_count) / 6;
+}
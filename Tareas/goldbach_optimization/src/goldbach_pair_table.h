@@ -0,0 +1,124 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_PAIR_TABLE_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_PAIR_TABLE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "array_int64.h"
+#include "prime_sieve.h"
+#include "prime_table.h"
+
+/// Numbers whose pairs are counted by a thread at once
+#define GOLDBACH_PAIR_TABLE_CHUNK_NUMBERS (INT64_C(1) << 16)
+/// Biggest limit of the table. The counts take 2 bytes per number, so the
+/// table takes at most the bytes of the biggest sieve
+#define GOLDBACH_PAIR_TABLE_MAX_LIMIT (PRIME_SIEVE_MAX_LIMIT / 32)
+
+/**
+ * @brief amount of goldbach pairs of every even number up to a limit.
+ * @details pair_counts[m/2] is the amount of pairs of odd primes q <= r with
+ * q + r = m, which is the amount of goldbach sums of every even m > 4. The
+ * weak conjecture counts are derived from it in O(pi(n)) per odd number.
+ * The table is filled by chunks of numbers that threads claim, like the
+ * segments of the sieve.
+ */
+typedef struct goldbach_pair_table {
+  /// Biggest number covered, 0 if the table is not used
+  int64_t limit;
+  uint32_t* pair_counts;
+  int64_t chunk_count;
+  /// Next chunk that has not been claimed by any thread
+  atomic_int_fast64_t next_chunk;
+  /// Amount of chunks that are filled
+  atomic_int_fast64_t filled_count;
+} goldbach_pair_table_t;
+
+/**
+ * @brief returns the limit of the table that is worth for some numbers.
+ * @details estimates the cost of counting the sums of the positive numbers
+ * one by one, and the cost of filling a table up to the biggest one. Numbers
+ * bigger than GOLDBACH_PAIR_TABLE_MAX_LIMIT are left to the count kernels.
+ * @param numbers the numbers given by the user.
+ * @return the biggest positive number that the table covers, or 0 if the
+ * table is not worth.
+ */
+int64_t goldbach_pair_table_choose_limit(array_int64_t* numbers);
+
+/**
+ * @brief returns the estimated cost of counting the sums of a number
+ * without the table.
+ * @param number positive number bigger than 5.
+ * @return the estimated amount of operations.
+ */
+double goldbach_pair_table_estimate_direct(int64_t number);
+
+/**
+ * @brief returns the estimated cost of filling a table up to a limit.
+ * @param limit biggest number covered by the table.
+ * @return the estimated amount of operations.
+ */
+double goldbach_pair_table_estimate_fill(int64_t limit);
+
+/**
+ * @brief initialize the goldbach_pair_table struct.
+ * @details allocates the counts, but does not fill them.
+ * @param table pointer to the table to be initialized.
+ * @param limit biggest number covered, 0 to disable the table.
+ * @return an integer to check errors.
+ */
+int goldbach_pair_table_init(goldbach_pair_table_t* table, int64_t limit);
+
+/**
+ * @brief makes the table cover a bigger limit.
+ * @details the pairs of an even number only depend on the primes below it,
+ * so the chunks that were filled are kept and only the new ones are filled
+ * when a thread requires the table. Must be called while no thread uses the
+ * table.
+ * @param table pointer to the table.
+ * @param limit new biggest number covered, bigger than the current one.
+ * @return an integer to check errors, the table keeps its limit on errors.
+ */
+int goldbach_pair_table_grow(goldbach_pair_table_t* table, int64_t limit);
+
+/**
+ * @brief destroys the goldbach_pair_table struct.
+ * @param table pointer to the table to be destroyed.
+ */
+void goldbach_pair_table_destroy(goldbach_pair_table_t* table);
+
+/**
+ * @brief waits until every chunk of the table is filled.
+ * @details the calling thread fills the unclaimed chunks, or yields if the
+ * other threads are filling the missing ones.
+ * @param table pointer to the table.
+ * @param primes table of primes that covers the limit of the table.
+ */
+void goldbach_pair_table_require(goldbach_pair_table_t* table,
+  const prime_table_t* primes);
+
+/**
+ * @brief returns the amount of goldbach sums of an even number.
+ * @param table pointer to the filled table.
+ * @param number even number bigger than 5 and not bigger than the limit.
+ * @return the amount of sums.
+ */
+int64_t goldbach_pair_table_count_strong(const goldbach_pair_table_t* table,
+  int64_t number);
+
+/**
+ * @brief returns the amount of goldbach sums of an odd number.
+ * @details counts the ordered triples of odd primes as a sum of pair counts,
+ * and the triples with repeated addends apart, to get the amount of sorted
+ * triples. The only sum with an even addend is 2 + 2 + (n - 4).
+ * @param table pointer to the filled table.
+ * @param primes table of primes that covers the number.
+ * @param number odd number bigger than 5 and not bigger than the limit.
+ * @return the amount of sums.
+ */
+int64_t goldbach_pair_table_count_weak(const goldbach_pair_table_t* table,
+  const prime_table_t* primes, int64_t number);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_PAIR_TABLE_H
@@ -22,6 +22,99 @@ goldbach_sums_array_t** create_goldbach_sums_matrix(array_int64_t* numbers);
 void free_goldbach_sums_matrix(const int64_t row_count,
   goldbach_sums_array_t** matrix);
 
+/**
+ * @brief plans the parts of every number.
+ * @details big numbers are split in parts that several consumers calculate,
+ * except the positive numbers counted from the pair table. Updates the
+ * amount of units that the consumers will consume.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @return an integer to check errors.
+ */
+int create_goldbach_splits(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief sorts the units by their estimated cost, longest first.
+ * @details the units are sorted within windows of as many numbers of the
+ * input as the window of the options, so the writer never waits for more
+ * numbers than the reorder buffer holds. The units of a split number share
+ * its cost. Units with the same cost keep the order of the input.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @return an integer to check errors.
+ */
+int create_unit_order(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief compares two units by ascending window, then by descending cost,
+ * then by ascending position.
+ * @param first pointer to the first unit_cost_t.
+ * @param second pointer to the second unit_cost_t.
+ * @return a negative number if first goes before second, positive otherwise.
+ */
+int compare_unit_costs(const void* first, const void* second);
+
+/**
+ * @brief prints the estimated and the actual cost of every number in stderr.
+ * @details also prints, for every class of numbers, the nanoseconds that one
+ * estimated operation takes. The model fits the data when the nanoseconds
+ * per operation are similar in every row of a class.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ */
+void print_cost_report(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief creates an empty deque for every consumer.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @return an integer to check errors.
+ */
+int create_goldbach_deques(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief deals the units of the batch to the consumers window by window.
+ * @details waits until every consumer finished the tasks of a window before
+ * it deals the next one, so thieves never calculate numbers further from the
+ * printed ones than a window. At the end, tells the consumers to stop.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param consumer_count consumers that take the tasks of the deques.
+ * @return an integer to check errors.
+ */
+int deal_goldbach_windows(goldbach_pthread_t* goldbach_pthread,
+  int64_t consumer_count);
+
+/**
+ * @brief deals the units at a range of positions to the deques.
+ * @details the units are dealt in turns in the order of the schedule, and
+ * every deque receives its units in reverse, so its owner takes them in the
+ * order of the schedule while the thieves steal from the other end. Only
+ * called while every consumer waits for the window.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param first first position of the window.
+ * @param last position after the window.
+ * @param consumer_count consumers that take the tasks of the deques.
+ * @return an integer to check errors.
+ */
+int deal_goldbach_window(goldbach_pthread_t* goldbach_pthread, int64_t first,
+  int64_t last, int64_t consumer_count);
+
+/**
+ * @brief frees the deques of the consumers.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ */
+void free_goldbach_deques(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief frees the parts of every number.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ */
+void free_goldbach_splits(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief returns the biggest absolute value of the numbers.
+ * @details the sieve must contain every number up to this value.
+ * @param numbers the numbers.
+ * @return the biggest absolute value of the numbers.
+ */
+int64_t find_max_number(array_int64_t* numbers);
+
 goldbach_pthread_t* goldbach_pthread_create(array_int64_t* numbers) {
   goldbach_pthread_t* goldbach_pthread = (goldbach_pthread_t*)
     calloc(1, sizeof(goldbach_pthread_t));
@@ -30,117 +123,403 @@ goldbach_pthread_t* goldbach_pthread_create(array_int64_t* numbers) {
     goldbach_pthread->numbers = numbers;
     goldbach_pthread->unit_count =
       array_int64_getCount(goldbach_pthread->numbers);
-    goldbach_number_queue_init(&goldbach_pthread->queue);
-    goldbach_pthread->consumed_count = 0;
-    sem_init(&goldbach_pthread->can_consume, 0, 0);
     sem_init(&goldbach_pthread->can_access_next_unit, 0, 1);
+    atomic_init(&goldbach_pthread->sleeping_count, 0);
+    pthread_mutex_init(&goldbach_pthread->can_access_sleeping, NULL);
+    pthread_cond_init(&goldbach_pthread->has_tasks, NULL);
+    pthread_mutex_init(&goldbach_pthread->can_access_windows, NULL);
+    pthread_cond_init(&goldbach_pthread->has_window, NULL);
+    pthread_cond_init(&goldbach_pthread->is_window_finished, NULL);
     goldbach_pthread->next_unit = 0;
-    sem_init(&goldbach_pthread->can_access_consumed_count, 0, 1);
-    goldbach_pthread->consumed_count = 0;
+    atomic_init(&goldbach_pthread->cursor, 0);
+    atomic_init(&goldbach_pthread->has_failed, false);
+    if (goldbach_number_queue_init(&goldbach_pthread->queue,
+      GOLDBACH_NUMBER_QUEUE_CAPACITY) != EXIT_SUCCESS) {
+      free(goldbach_pthread);
+      goldbach_pthread = NULL;
+    }
   }
 
 
   return goldbach_pthread;
 }
 
-int goldbach_pthread_run(goldbach_pthread_t* goldbach_pthread, int argc,
+int goldbach_pthread_read(goldbach_pthread_t* goldbach_pthread, int argc,
   char* argv[]) {
   assert(goldbach_pthread);
-  int error = EXIT_SUCCESS;
-  // Assign consumer_count
-  goldbach_pthread->consumer_count = sysconf(_SC_NPROCESSORS_ONLN);
-  if (goldbach_pthread) {
-    if (argc == 2) {
-      if (sscanf(argv[1], "%zu", &goldbach_pthread->consumer_count) != 1
-        || errno) {
-        fprintf(stderr, "error: invalid thread count\n");
-        error = 1;
+  const int error = goldbach_options_parse(&goldbach_pthread->options, argc,
+    argv);
+  if (error == EXIT_SUCCESS && !goldbach_pthread->options.stream) {
+    int64_t number = 0;
+    while (scanf("%" SCNd64, &number) == 1) {
+      if (number == INT64_MIN) {
+        fprintf(stderr, "error: the magnitude of %" PRId64 " does not fit "
+          "in 64 bits\n", number);
+        return 30;
+      }
+      if (array_int64_append(goldbach_pthread->numbers, number)
+        != EXIT_SUCCESS) {
+        fprintf(stderr, "error: could not allocate the numbers\n");
+        return 30;
       }
     }
-    if (error == EXIT_SUCCESS) {
-      // Create goldbach sums matrix to use conditionally safety
-      goldbach_pthread->goldbach_sums = create_goldbach_sums_matrix(
-        goldbach_pthread->numbers);
-    }
-    // Create consumers and producers
-    error = create_consumers_producers(goldbach_pthread);
-    // Print the results
-    for (int64_t index = 0; index < array_int64_getCount(
-      goldbach_pthread->numbers); index++) {
-      goldbach_sums_array_print(goldbach_pthread->goldbach_sums[index]);
-    }
-
-    goldbach_number_queue_destroy(&goldbach_pthread->queue);
+  }
+  return error;
+}
 
-    // Free matrix after all calculations finished
-    free_goldbach_sums_matrix(array_int64_getCount(goldbach_pthread->numbers),
-      goldbach_pthread->goldbach_sums);
+int goldbach_pthread_run(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
+  int error = goldbach_pthread_start(goldbach_pthread);
+  if (error == EXIT_SUCCESS && goldbach_pthread->options.stream) {
+    error = goldbach_pthread_run_stream(goldbach_pthread);
+  } else if (error == EXIT_SUCCESS) {
+    error = goldbach_pthread_run_batch(goldbach_pthread,
+      goldbach_pthread->numbers);
   }
   return error;
 }
 
-int create_consumers_producers(goldbach_pthread_t* goldbach_pthread) {
+int goldbach_pthread_start(goldbach_pthread_t* goldbach_pthread) {
   assert(goldbach_pthread);
-  int error = EXIT_SUCCESS;
-  int64_t producer_count = 1;
-  // Create 1 thread(producer) to produce
-  pthread_t* producer = create_threads(producer_count, produce
-    , goldbach_pthread);
-  // Create as many threads(consumers) as the user asked to consume
-  pthread_t* consumers = create_threads(goldbach_pthread->consumer_count,
-    consume, goldbach_pthread);
-
-  // join of threads
-  if (producer && consumers) {
-    wait_threads(producer_count, producer);
-    for (int64_t index = 0; index < goldbach_pthread->consumer_count; ++index) {
-      sem_post(&goldbach_pthread->can_consume);
-    }
-    wait_threads(goldbach_pthread->consumer_count, consumers);
-  } else {
+  // Assign consumer_count
+  goldbach_pthread->consumer_count = goldbach_pthread->options.thread_count;
+  goldbach_claim_init(&goldbach_pthread->claim,
+    goldbach_pthread->options.chunk_size);
+  // The producer runs in the calling thread, and the writer in one more
+  // worker, with the last private data
+  goldbach_pthread->private_data = (private_data_t*) calloc(
+    (size_t)goldbach_pthread->consumer_count + 2, sizeof(private_data_t));
+  goldbach_pthread->arenas = (goldbach_arena_t*) calloc(
+    (size_t)goldbach_pthread->consumer_count, sizeof(goldbach_arena_t));
+  if (goldbach_pthread->private_data == NULL
+    || goldbach_pthread->arenas == NULL || thread_pool_init(
+    &goldbach_pthread->pool, goldbach_pthread->consumer_count + 1)
+    != EXIT_SUCCESS) {
     fprintf(stderr, "error: could not allocate create threads\n");
-    error = 22;
+    return 22;
+  }
+  for (int64_t index = 0; index < goldbach_pthread->consumer_count + 2;
+    ++index) {
+    goldbach_pthread->private_data[index].thread_number = index;
+    goldbach_pthread->private_data[index].goldbach_pthread = goldbach_pthread;
   }
+  for (int64_t index = 0; index < goldbach_pthread->consumer_count; ++index) {
+    goldbach_arena_init(&goldbach_pthread->arenas[index]);
+  }
+  if (goldbach_output_init(&goldbach_pthread->output, STDOUT_FILENO)
+    != EXIT_SUCCESS) {
+    fprintf(stderr, "error: could not allocate the output\n");
+    return 33;
+  }
+  return create_placement(goldbach_pthread);
+}
 
+int create_placement(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
+  const goldbach_options_t* options = &goldbach_pthread->options;
+  if (options->affinity == GOLDBACH_AFFINITY_NONE && !options->avoid_smt) {
+    return EXIT_SUCCESS;
+  }
+  if (cpu_topology_init(&goldbach_pthread->topology) != EXIT_SUCCESS) {
+    cpu_topology_destroy(&goldbach_pthread->topology);
+    fprintf(stderr, "error: could not read the processors\n");
+    return 32;
+  }
+  if (options->affinity == GOLDBACH_AFFINITY_SCATTER) {
+    cpu_topology_sort_scatter(&goldbach_pthread->topology);
+  } else {
+    cpu_topology_sort_compact(&goldbach_pthread->topology);
+  }
+  if (options->avoid_smt) {
+    cpu_topology_keep_cores(&goldbach_pthread->topology);
+  }
+  return EXIT_SUCCESS;
+}
+
+int goldbach_pthread_run_stream(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
+  int error = EXIT_SUCCESS;
+  goldbach_stream_t stream;
+  goldbach_reorder_buffer_t reorder_buffer;
+  if (goldbach_stream_init(&stream) != EXIT_SUCCESS) {
+    goldbach_stream_destroy(&stream);
+    fprintf(stderr, "error: could not allocate the stream\n");
+    return 30;
+  }
+  if (goldbach_reorder_buffer_init(&reorder_buffer,
+    goldbach_pthread->options.window) != EXIT_SUCCESS) {
+    goldbach_reorder_buffer_destroy(&reorder_buffer);
+    goldbach_stream_destroy(&stream);
+    fprintf(stderr, "error: could not allocate the reorder buffer\n");
+    return 31;
+  }
+  goldbach_pthread->stream = &stream;
+  goldbach_pthread->reorder_buffer = &reorder_buffer;
+  // The stream hands the units out through the queue in the input order
+  goldbach_pthread->options.schedule = GOLDBACH_SCHEDULE_QUEUE;
+  // The sieve grows with the numbers that arrive
+  if (goldbach_pthread->sieve.hazards == NULL && prime_sieve_init(
+    &goldbach_pthread->sieve, 0, goldbach_pthread->consumer_count)
+    != EXIT_SUCCESS) {
+    fprintf(stderr, "error: could not allocate the prime sieve\n");
+    error = 23;
+  }
+
+  if (error == EXIT_SUCCESS) {
+    const int64_t consumer_count = submit_consumers(goldbach_pthread,
+      consume);
+    if (consumer_count < goldbach_pthread->consumer_count
+      || submit_writer(goldbach_pthread) != EXIT_SUCCESS) {
+      // The writer, if it was submitted, stops at once
+      goldbach_reorder_buffer_close(&reorder_buffer, 0);
+      error = 22;
+    } else {
+      // This thread is the reader
+      produce_stream(
+        &goldbach_pthread->private_data[goldbach_pthread->consumer_count]);
+    }
+    // One unit without number stops every consumer
+    const goldbach_number_t stop_unit = {0, -1, 0, 0, 0, 0};
+    for (int64_t index = 0; index < consumer_count; ++index) {
+      goldbach_number_queue_enqueue(&goldbach_pthread->queue, stop_unit);
+    }
+    thread_pool_wait(&goldbach_pthread->pool);
+    if (error == EXIT_SUCCESS && atomic_load(&stream.has_failed)) {
+      error = 30;
+    }
+    error = error ? error : check_sums(goldbach_pthread);
+    error = error ? error : check_output(goldbach_pthread);
+  }
+
+  goldbach_pthread->stream = NULL;
+  goldbach_pthread->reorder_buffer = NULL;
+  goldbach_stream_destroy(&stream);
+  goldbach_reorder_buffer_destroy(&reorder_buffer);
   return error;
 }
 
-pthread_t* create_threads(size_t count, void*(*subroutine)(void*),
-  goldbach_pthread_t* data) {
-  pthread_t* threads = (pthread_t*) calloc(count, sizeof(pthread_t));
-  // Create as many private_data as threads
-  private_data_t* private_data = (private_data_t*)
-    calloc(count, sizeof(private_data_t));
-  if (threads) {
-    for (size_t index = 0; index < count; ++index) {
-      private_data[index].thread_number = index;
-      // data is goldbach_pthread (shared_data)
-      private_data[index].goldbach_pthread = data;
-
-      // "Link" threads with its private_data (GoldbachNumbers are
-      // stored in each private_data when consumed)
-      if (pthread_create(&threads[index], /*attr*/ NULL, subroutine,
-        &private_data[index]) == EXIT_SUCCESS) {
-      } else {
-        fprintf(stderr, "error: could not create thread %zu\n", index);
-        break;
-      }
+int goldbach_pthread_run_batch(goldbach_pthread_t* goldbach_pthread,
+  array_int64_t* numbers) {
+  assert(goldbach_pthread);
+  assert(numbers);
+  int error = EXIT_SUCCESS;
+  goldbach_pthread->numbers = numbers;
+  goldbach_pthread->next_unit = 0;
+  atomic_store(&goldbach_pthread->cursor, 0);
+  // Create goldbach sums matrix to use conditionally safety
+  goldbach_pthread->goldbach_sums = create_goldbach_sums_matrix(numbers);
+  if (goldbach_pthread->goldbach_sums == NULL) {
+    fprintf(stderr, "error: could not allocate the sums\n");
+    error = 29;
+  }
+  // Consumers sieve the segments of the shared sieve on demand, the sieve
+  // of the first batch grows for the bigger numbers of the next ones
+  if (error == EXIT_SUCCESS && goldbach_pthread->sieve.hazards == NULL) {
+    if (prime_sieve_init(&goldbach_pthread->sieve, find_max_number(numbers),
+      goldbach_pthread->consumer_count) != EXIT_SUCCESS) {
+      fprintf(stderr, "error: could not allocate the prime sieve\n");
+      error = 23;
+    }
+  }
+  if (error == EXIT_SUCCESS) {
+    // The amounts of sums of many positive numbers come from a shared table,
+    // that is kept while it covers the numbers of the batch
+    const int64_t pair_limit = goldbach_pthread->options.kernel
+      == GOLDBACH_KERNEL_LIST ? goldbach_pair_table_choose_limit(numbers) : 0;
+    if (pair_limit > goldbach_pthread->pair_table.limit) {
+      goldbach_pair_table_destroy(&goldbach_pthread->pair_table);
+      // Without the table the count kernels answer every number, so the
+      // table is left with limit 0 if it could not be allocated
+      goldbach_pair_table_init(&goldbach_pthread->pair_table, pair_limit);
     }
   }
-  return threads;
+  if (error == EXIT_SUCCESS) {
+    error = create_goldbach_splits(goldbach_pthread);
+  }
+  if (error == EXIT_SUCCESS
+    && goldbach_pthread->options.order == GOLDBACH_ORDER_COST) {
+    error = create_unit_order(goldbach_pthread);
+  }
+  if (error == EXIT_SUCCESS && goldbach_pthread->options.cost_report) {
+    goldbach_pthread->elapsed_times = (atomic_int_fast64_t*) calloc(
+      (size_t)array_int64_getCount(numbers), sizeof(atomic_int_fast64_t));
+    if (goldbach_pthread->elapsed_times == NULL) {
+      fprintf(stderr, "error: could not allocate the cost report\n");
+      error = 26;
+    }
+  }
+  goldbach_reorder_buffer_t reorder_buffer;
+  if (error == EXIT_SUCCESS) {
+    error = create_reorder_buffer(goldbach_pthread, &reorder_buffer);
+  }
+  if (error == EXIT_SUCCESS) {
+    // The writer prints the results while the consumers calculate the rest
+    error = submit_writer(goldbach_pthread);
+    if (error == EXIT_SUCCESS) {
+      // Create consumers and producers
+      error = create_consumers_producers(goldbach_pthread);
+    }
+    error = error ? error : check_sums(goldbach_pthread);
+    error = error ? error : check_output(goldbach_pthread);
+    if (goldbach_pthread->elapsed_times) {
+      print_cost_report(goldbach_pthread);
+    }
+    goldbach_pthread->reorder_buffer = NULL;
+    goldbach_reorder_buffer_destroy(&reorder_buffer);
+  }
+
+  free_goldbach_splits(goldbach_pthread);
+  free(goldbach_pthread->unit_order);
+  goldbach_pthread->unit_order = NULL;
+  free(goldbach_pthread->elapsed_times);
+  goldbach_pthread->elapsed_times = NULL;
+
+  // Free matrix after all calculations finished
+  free_goldbach_sums_matrix(array_int64_getCount(numbers),
+    goldbach_pthread->goldbach_sums);
+  goldbach_pthread->goldbach_sums = NULL;
+  return error;
+}
+
+int create_reorder_buffer(goldbach_pthread_t* goldbach_pthread,
+  goldbach_reorder_buffer_t* reorder_buffer) {
+  assert(goldbach_pthread);
+  assert(reorder_buffer);
+  const int64_t count = array_int64_getCount(goldbach_pthread->numbers);
+  // Every schedule hands out the numbers of a window before the next one
+  int64_t capacity = count;
+  if (goldbach_pthread->options.window < count) {
+    capacity = goldbach_pthread->options.window;
+  }
+  if (goldbach_reorder_buffer_init(reorder_buffer, capacity > 0 ? capacity
+    : 1) != EXIT_SUCCESS) {
+    goldbach_reorder_buffer_destroy(reorder_buffer);
+    fprintf(stderr, "error: could not allocate the reorder buffer\n");
+    return 31;
+  }
+  // Every number of the batch is known
+  goldbach_reorder_buffer_close(reorder_buffer, count);
+  goldbach_pthread->reorder_buffer = reorder_buffer;
+  return EXIT_SUCCESS;
+}
+
+int submit_writer(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
+  if (thread_pool_submit(&goldbach_pthread->pool, write_results,
+    &goldbach_pthread->private_data[goldbach_pthread->consumer_count + 1])
+    != EXIT_SUCCESS) {
+    fprintf(stderr, "error: could not submit the writer\n");
+    return 22;
+  }
+  return EXIT_SUCCESS;
+}
+
+int check_sums(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
+  if (atomic_exchange(&goldbach_pthread->has_failed, false)) {
+    fprintf(stderr, "error: could not allocate the sums\n");
+    return 29;
+  }
+  return EXIT_SUCCESS;
+}
+
+int check_output(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
+  if (goldbach_pthread->output.has_failed) {
+    fprintf(stderr, "error: could not write the output\n");
+    return 33;
+  }
+  return EXIT_SUCCESS;
 }
 
-int wait_threads(size_t count, pthread_t* threads) {
+int create_consumers_producers(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
   int error = EXIT_SUCCESS;
-  for (size_t index = 0; index < count; ++index) {
-    error += pthread_join(threads[index], /*value_ptr*/ NULL);
+  // Consumers take the tasks from their deques and steal the others
+  if (goldbach_pthread->options.schedule == GOLDBACH_SCHEDULE_STEAL) {
+    error = create_goldbach_deques(goldbach_pthread);
+    if (error == EXIT_SUCCESS) {
+      const int64_t consumer_count = submit_consumers(goldbach_pthread,
+        consume_steal);
+      if (consumer_count < goldbach_pthread->consumer_count) {
+        error = 22;
+      }
+      const int deal_error = deal_goldbach_windows(goldbach_pthread,
+        consumer_count);
+      error = error ? error : deal_error;
+      thread_pool_wait(&goldbach_pthread->pool);
+    }
+    free_goldbach_deques(goldbach_pthread);
+    return error;
   }
-  free(threads);
+
+  // Consumers claim the units by themselves with the cursor schedule
+  if (goldbach_pthread->options.schedule == GOLDBACH_SCHEDULE_CURSOR) {
+    if (submit_consumers(goldbach_pthread, consume_cursor)
+      < goldbach_pthread->consumer_count) {
+      error = 22;
+    }
+    thread_pool_wait(&goldbach_pthread->pool);
+    return error;
+  }
+
+  // As many consumers as the user asked consume while this thread produces
+  const int64_t consumer_count = submit_consumers(goldbach_pthread, consume);
+  if (consumer_count < goldbach_pthread->consumer_count) {
+    error = 22;
+  }
+  produce(&goldbach_pthread->private_data[goldbach_pthread->consumer_count]);
+  // One unit without number stops every consumer
+  const goldbach_number_t stop_unit = {0, -1, 0, 0, 0, 0};
+  for (int64_t index = 0; index < consumer_count; ++index) {
+    goldbach_number_queue_enqueue(&goldbach_pthread->queue, stop_unit);
+  }
+  thread_pool_wait(&goldbach_pthread->pool);
   return error;
 }
 
+int64_t submit_consumers(goldbach_pthread_t* goldbach_pthread,
+  void*(*subroutine)(void*)) {
+  assert(goldbach_pthread);
+  int64_t index = 0;
+  for (; index < goldbach_pthread->consumer_count; ++index) {
+    // "Link" consumers with its private_data (GoldbachNumbers are
+    // stored in each private_data when consumed)
+    if (thread_pool_submit(&goldbach_pthread->pool, subroutine,
+      &goldbach_pthread->private_data[index]) != EXIT_SUCCESS) {
+      fprintf(stderr, "error: could not submit consumer %" PRId64 "\n",
+        index);
+      break;
+    }
+  }
+  return index;
+}
+
 int goldbach_pthread_destroy(goldbach_pthread_t* goldbach_pthread) {
   assert(goldbach_pthread);
+  if (goldbach_pthread->pool.threads) {
+    thread_pool_destroy(&goldbach_pthread->pool);
+  }
+  free(goldbach_pthread->private_data);
+  goldbach_number_queue_destroy(&goldbach_pthread->queue);
+  sem_destroy(&goldbach_pthread->can_access_next_unit);
+  pthread_cond_destroy(&goldbach_pthread->has_tasks);
+  pthread_mutex_destroy(&goldbach_pthread->can_access_sleeping);
+  pthread_cond_destroy(&goldbach_pthread->is_window_finished);
+  pthread_cond_destroy(&goldbach_pthread->has_window);
+  pthread_mutex_destroy(&goldbach_pthread->can_access_windows);
+  prime_sieve_destroy(&goldbach_pthread->sieve);
+  goldbach_pair_table_destroy(&goldbach_pthread->pair_table);
+  cpu_topology_destroy(&goldbach_pthread->topology);
+  // Every sums array gave its chunks back
+  if (goldbach_pthread->arenas) {
+    for (int64_t index = 0; index < goldbach_pthread->consumer_count;
+      ++index) {
+      goldbach_arena_destroy(&goldbach_pthread->arenas[index]);
+    }
+  }
+  free(goldbach_pthread->arenas);
+  goldbach_output_destroy(&goldbach_pthread->output);
   free(goldbach_pthread);
   return EXIT_SUCCESS;
 }
@@ -149,7 +528,7 @@ goldbach_sums_array_t** create_goldbach_sums_matrix(array_int64_t* numbers) {
   assert(numbers);
   goldbach_sums_array_t** matrix = (goldbach_sums_array_t**)
     calloc((size_t)array_int64_getCount(numbers), sizeof(
-    goldbach_sums_array_t));
+    goldbach_sums_array_t*));
   if (matrix == NULL) {
     return NULL;
   }
@@ -179,3 +558,255 @@ void free_goldbach_sums_matrix(const int64_t row_count,
   free(matrix);
 }
 
+int64_t find_max_number(array_int64_t* numbers) {
+  assert(numbers);
+  int64_t max_number = 0;
+  for (int64_t index = 0; index < array_int64_getCount(numbers); ++index) {
+    int64_t number = array_int64_getElement(numbers, index);
+    if (number < 0) {
+      number *= -1;
+    }
+    if (number > max_number) {
+      max_number = number;
+    }
+  }
+  return max_number;
+}
+
+int create_goldbach_splits(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
+  const int64_t count = array_int64_getCount(goldbach_pthread->numbers);
+  goldbach_pthread->splits = (goldbach_split_t*) calloc((size_t)count,
+    sizeof(goldbach_split_t));
+  if (goldbach_pthread->splits == NULL) {
+    fprintf(stderr, "error: could not allocate the parts of the numbers\n");
+    return 25;
+  }
+
+  goldbach_pthread->unit_count = 0;
+  for (int64_t index = 0; index < count; ++index) {
+    const int64_t number = array_int64_getElement(goldbach_pthread->numbers,
+      index);
+    int64_t part_count = 1;
+    // Counting from the table takes much less than a part
+    if (number < 0 || number > goldbach_pthread->pair_table.limit) {
+      part_count = goldbach_split_choose_part_count(goldbach_cost_estimate(
+        number, goldbach_pthread->pair_table.limit,
+        goldbach_pthread->options.kernel), goldbach_pthread->consumer_count);
+    }
+    goldbach_split_init(&goldbach_pthread->splits[index], part_count);
+    goldbach_pthread->splits[index].first_unit = goldbach_pthread->unit_count;
+    goldbach_pthread->unit_count += part_count;
+  }
+  return EXIT_SUCCESS;
+}
+
+int create_goldbach_deques(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
+  const int64_t consumer_count = goldbach_pthread->consumer_count;
+  goldbach_pthread->deques = (goldbach_deque_t*) calloc(
+    (size_t)consumer_count, sizeof(goldbach_deque_t));
+  if (goldbach_pthread->deques == NULL) {
+    fprintf(stderr, "error: could not allocate the deques\n");
+    return 28;
+  }
+  int error = EXIT_SUCCESS;
+  for (int64_t index = 0; index < consumer_count; ++index) {
+    error = error ? error : goldbach_deque_init(
+      &goldbach_pthread->deques[index]);
+  }
+  if (error) {
+    fprintf(stderr, "error: could not allocate the deques\n");
+    return 28;
+  }
+
+  atomic_store(&goldbach_pthread->pending_task_count, 0);
+  atomic_store(&goldbach_pthread->idle_count, 0);
+  goldbach_pthread->dealt_window_count = 0;
+  goldbach_pthread->waiting_count = 0;
+  return EXIT_SUCCESS;
+}
+
+int deal_goldbach_windows(goldbach_pthread_t* goldbach_pthread,
+  int64_t consumer_count) {
+  assert(goldbach_pthread);
+  int error = EXIT_SUCCESS;
+  int64_t first = 0;
+  while (true) {
+    // The deques are only touched by this thread while every consumer waits
+    pthread_mutex_lock(&goldbach_pthread->can_access_windows);
+    while (goldbach_pthread->waiting_count < consumer_count) {
+      pthread_cond_wait(&goldbach_pthread->is_window_finished,
+        &goldbach_pthread->can_access_windows);
+    }
+    pthread_mutex_unlock(&goldbach_pthread->can_access_windows);
+
+    const bool is_dealing = first < goldbach_pthread->unit_count
+      && consumer_count > 0 && error == EXIT_SUCCESS;
+    if (is_dealing) {
+      const int64_t last = goldbach_pthread_get_window_end(goldbach_pthread,
+        first);
+      error = deal_goldbach_window(goldbach_pthread, first, last,
+        consumer_count);
+      first = last;
+    }
+
+    pthread_mutex_lock(&goldbach_pthread->can_access_windows);
+    goldbach_pthread->waiting_count = 0;
+    goldbach_pthread->dealt_window_count = is_dealing
+      ? goldbach_pthread->dealt_window_count + 1 : -1;
+    pthread_cond_broadcast(&goldbach_pthread->has_window);
+    pthread_mutex_unlock(&goldbach_pthread->can_access_windows);
+    if (!is_dealing) {
+      break;
+    }
+  }
+  return error;
+}
+
+int deal_goldbach_window(goldbach_pthread_t* goldbach_pthread, int64_t first,
+  int64_t last, int64_t consumer_count) {
+  assert(goldbach_pthread);
+  int error = EXIT_SUCCESS;
+  int64_t dealt_count = 0;
+  for (int64_t position = last - 1; position >= first; --position) {
+    goldbach_number_t* task = (goldbach_number_t*)
+      malloc(sizeof(goldbach_number_t));
+    if (task == NULL) {
+      error = EXIT_FAILURE;
+      break;
+    }
+    goldbach_pthread_get_unit(goldbach_pthread, position, task);
+    error = goldbach_deque_push(&goldbach_pthread->deques[
+      position % consumer_count], task);
+    if (error) {
+      free(task);
+      break;
+    }
+    ++dealt_count;
+  }
+  // The consumers still finish the tasks that were dealt
+  atomic_store(&goldbach_pthread->pending_task_count, dealt_count);
+
+  if (error) {
+    fprintf(stderr, "error: could not allocate the tasks\n");
+    error = 28;
+  }
+  return error;
+}
+
+void free_goldbach_deques(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
+  if (goldbach_pthread->deques) {
+    for (int64_t index = 0; index < goldbach_pthread->consumer_count;
+      ++index) {
+      goldbach_deque_destroy(&goldbach_pthread->deques[index]);
+    }
+    free(goldbach_pthread->deques);
+    goldbach_pthread->deques = NULL;
+  }
+}
+
+/// Estimated cost of a unit, used to sort the units
+typedef struct {
+  /// Window of the number of the unit, the windows keep the input order
+  int64_t window;
+  double cost;
+  int64_t unit;
+} unit_cost_t;
+
+int create_unit_order(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
+  const int64_t unit_count = goldbach_pthread->unit_count;
+  unit_cost_t* unit_costs = (unit_cost_t*) calloc((size_t)unit_count,
+    sizeof(unit_cost_t));
+  goldbach_pthread->unit_order = (int64_t*) calloc((size_t)unit_count,
+    sizeof(int64_t));
+  if (unit_costs == NULL || goldbach_pthread->unit_order == NULL) {
+    free(unit_costs);
+    fprintf(stderr, "error: could not allocate the order of the units\n");
+    return 27;
+  }
+
+  for (int64_t index = 0; index < array_int64_getCount(
+    goldbach_pthread->numbers); ++index) {
+    const goldbach_split_t* split = &goldbach_pthread->splits[index];
+    const double cost = goldbach_cost_estimate(array_int64_getElement(
+      goldbach_pthread->numbers, index), goldbach_pthread->pair_table.limit,
+      goldbach_pthread->options.kernel) / split->part_count;
+    for (int64_t part = 0; part < split->part_count; ++part) {
+      unit_costs[split->first_unit + part].window = index
+        / goldbach_pthread->options.window;
+      unit_costs[split->first_unit + part].cost = cost;
+      unit_costs[split->first_unit + part].unit = split->first_unit + part;
+    }
+  }
+
+  qsort(unit_costs, (size_t)unit_count, sizeof(unit_cost_t),
+    compare_unit_costs);
+  for (int64_t position = 0; position < unit_count; ++position) {
+    goldbach_pthread->unit_order[position] = unit_costs[position].unit;
+  }
+  free(unit_costs);
+  return EXIT_SUCCESS;
+}
+
+int compare_unit_costs(const void* first, const void* second) {
+  const unit_cost_t* first_unit = (const unit_cost_t*)first;
+  const unit_cost_t* second_unit = (const unit_cost_t*)second;
+  if (first_unit->window != second_unit->window) {
+    return first_unit->window < second_unit->window ? -1 : 1;
+  }
+  if (first_unit->cost != second_unit->cost) {
+    return first_unit->cost > second_unit->cost ? -1 : 1;
+  }
+  return (first_unit->unit > second_unit->unit)
+    - (first_unit->unit < second_unit->unit);
+}
+
+void print_cost_report(goldbach_pthread_t* goldbach_pthread) {
+  static const char* const class_names[GOLDBACH_COST_CLASS_COUNT] = {
+    "weak", "strong", "table"
+  };
+  double estimated_totals[GOLDBACH_COST_CLASS_COUNT] = {0};
+  double elapsed_totals[GOLDBACH_COST_CLASS_COUNT] = {0};
+
+  fprintf(stderr, "number\tclass\testimated\telapsed_ns\tns_per_op\n");
+  for (int64_t index = 0; index < array_int64_getCount(
+    goldbach_pthread->numbers); ++index) {
+    const int64_t number = array_int64_getElement(goldbach_pthread->numbers,
+      index);
+    const goldbach_cost_class_t cost_class = goldbach_cost_classify(number,
+      goldbach_pthread->pair_table.limit);
+    const double estimated = goldbach_cost_estimate(number,
+      goldbach_pthread->pair_table.limit, goldbach_pthread->options.kernel);
+    const int64_t elapsed = atomic_load(
+      &goldbach_pthread->elapsed_times[index]);
+    fprintf(stderr, "%" PRId64 "\t%s\t%.0f\t%" PRId64 "\t%.3f\n", number,
+      class_names[cost_class], estimated, elapsed, elapsed / estimated);
+    estimated_totals[cost_class] += estimated;
+    elapsed_totals[cost_class] += elapsed;
+  }
+
+  for (int cost_class = 0; cost_class < GOLDBACH_COST_CLASS_COUNT;
+    ++cost_class) {
+    if (estimated_totals[cost_class] > 0) {
+      fprintf(stderr, "total\t%s\t%.0f\t%.0f\t%.3f\n",
+        class_names[cost_class], estimated_totals[cost_class],
+        elapsed_totals[cost_class],
+        elapsed_totals[cost_class] / estimated_totals[cost_class]);
+    }
+  }
+}
+
+void free_goldbach_splits(goldbach_pthread_t* goldbach_pthread) {
+  assert(goldbach_pthread);
+  if (goldbach_pthread->splits) {
+    for (int64_t index = 0; index < array_int64_getCount(
+      goldbach_pthread->numbers); ++index) {
+      goldbach_split_destroy(&goldbach_pthread->splits[index]);
+    }
+    free(goldbach_pthread->splits);
+    goldbach_pthread->splits = NULL;
+  }
+}
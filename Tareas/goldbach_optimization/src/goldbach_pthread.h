@@ -10,6 +10,7 @@
 #include "common.h"
 #include "consumer.h"
 #include "producer.h"
+#include "writer.h"
 
 /**
  * @brief creates and initialize the goldbach_sums_array struct.
@@ -20,34 +21,126 @@
 goldbach_pthread_t* goldbach_pthread_create(array_int64_t* numbers);
 
 /**
- * @brief prepares execution of program does the things
- * @details verifies if number of threads was given by the user, creates the 
- * matrix for conditionally safe and calls to create threads and continue the
- * execution of the program.
+ * @brief parses the options and reads the input of a batch.
+ * @details parses the options given by the user. Without --stream, reads the
+ * numbers of stdin in the array given to goldbach_pthread_create(), so the
+ * time of goldbach_pthread_run() does not include the input.
  * @param goldbach_pthread struct that contains the shared data of the threads.
  * @param argc amount of arguments given in console.
  * @param argv arguments given in console.
  * @return an integer to check errors.
  */
-int goldbach_pthread_run(goldbach_pthread_t* goldbach_pthread, int argc,
+int goldbach_pthread_read(goldbach_pthread_t* goldbach_pthread, int argc,
   char* argv[]);
 
-int create_consumers_producers(goldbach_pthread_t* goldbach_pthread);
-pthread_t* create_threads(size_t count, void*(*subroutine)(void*),
-  goldbach_pthread_t* data);
-int wait_threads(size_t count, pthread_t* threads);
 /**
- * @brief creates the threads and puts them to do the calculations.
- * @details creates the threads, puts them to do the calculations, joins the
- * threads and prints the results.
+ * @brief prepares execution of program does the things
+ * @details starts the thread pool and runs the numbers read by
+ * goldbach_pthread_read() as one batch, or with --stream calculates and
+ * prints them while they are read.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @return an integer to check errors.
+ */
+int goldbach_pthread_run(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief creates the consumers that calculate every batch.
+ * @details creates the thread pool and the private data of the threads, and
+ * the placement of the consumers on the processors. The options must be
+ * parsed.
  * @param goldbach_pthread struct that contains the shared data of the threads.
  * @return an integer to check errors.
  */
-int goldbach_pthread_create_threads(goldbach_pthread_t* goldbach_pthread);
+int goldbach_pthread_start(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief orders the processors where the consumers are pinned.
+ * @details reads the topology only when an affinity or --no-smt is given,
+ * otherwise the consumers are not pinned.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @return an integer to check errors.
+ */
+int create_placement(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief calculates and prints the goldbach sums of a batch of numbers.
+ * @details runs on the thread pool created by goldbach_pthread_start(). One
+ * worker prints the numbers and frees their results as soon as the numbers
+ * before them are printed. The sieve and the pair table are kept for the
+ * next batches.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param numbers the numbers of the batch, they must live until the batch
+ * finishes.
+ * @return an integer to check errors.
+ */
+int goldbach_pthread_run_batch(goldbach_pthread_t* goldbach_pthread,
+  array_int64_t* numbers);
+
+/**
+ * @brief calculates and prints the numbers of stdin while they are read.
+ * @details this thread reads the numbers and enqueues their units, the
+ * consumers of the pool calculate them, and one more worker of the pool
+ * prints them in the order of the input as soon as they are finished. The
+ * reader waits while the window of numbers that are not printed is full.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @return an integer to check errors.
+ */
+int goldbach_pthread_run_stream(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief creates the reorder buffer of a batch.
+ * @details the window of the buffer is the window of the options, or the
+ * whole batch when it is shorter.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param reorder_buffer the buffer to be initialized.
+ * @return an integer to check errors.
+ */
+int create_reorder_buffer(goldbach_pthread_t* goldbach_pthread,
+  goldbach_reorder_buffer_t* reorder_buffer);
+
+/**
+ * @brief submits the writer of the results to the thread pool.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @return an integer to check errors.
+ */
+int submit_writer(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief checks that every unit could store its sums.
+ * @details called after the writer finished, and clears the failure for the
+ * next batch.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @return an integer to check errors.
+ */
+int check_sums(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief checks that the writer could write every result to stdout.
+ * @details called after the writer finished.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @return an integer to check errors.
+ */
+int check_output(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief calculates the units of the batch with the schedule of the options.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @return an integer to check errors.
+ */
+int create_consumers_producers(goldbach_pthread_t* goldbach_pthread);
+
+/**
+ * @brief submits one task per consumer to the thread pool.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param subroutine the subroutine of the consumers.
+ * @return the amount of consumers that were submitted.
+ */
+int64_t submit_consumers(goldbach_pthread_t* goldbach_pthread,
+  void*(*subroutine)(void*));
 
 /**
  * @brief destroys the goldbach_pthread struct.
- * @details destroys the goldbach_pthread struct.
+ * @details stops the thread pool and frees the data shared by the batches.
  * @param goldbach_pthread pointer to the struct to be destroyed.
  * @return an integer to check errors.
  */
@@ -0,0 +1,139 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "goldbach_reorder_buffer.h"
+
+/**
+ * @brief returns if the number after the prefix finished or every number
+ * was printed.
+ * @details the caller must lock can_access_slots.
+ * @param buffer pointer to the buffer.
+ * @return true if the writer does not have to wait.
+ */
+bool goldbach_reorder_buffer_can_take(goldbach_reorder_buffer_t* buffer);
+
+int goldbach_reorder_buffer_init(goldbach_reorder_buffer_t* buffer,
+  int64_t capacity) {
+  assert(buffer);
+  assert(capacity > 0);
+  buffer->capacity = capacity;
+  buffer->flushed_count = 0;
+  buffer->waiting_count = 0;
+  buffer->count = 0;
+  buffer->is_closed = false;
+  pthread_mutex_init(&buffer->can_access_slots, NULL);
+  pthread_cond_init(&buffer->has_finished, NULL);
+  pthread_cond_init(&buffer->has_room, NULL);
+  buffer->finished = (int64_t*) calloc((size_t)capacity, sizeof(int64_t));
+  return buffer->finished ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void goldbach_reorder_buffer_destroy(goldbach_reorder_buffer_t* buffer) {
+  assert(buffer);
+  free(buffer->finished);
+  buffer->finished = NULL;
+  pthread_cond_destroy(&buffer->has_room);
+  pthread_cond_destroy(&buffer->has_finished);
+  pthread_mutex_destroy(&buffer->can_access_slots);
+}
+
+void goldbach_reorder_buffer_reserve(goldbach_reorder_buffer_t* buffer,
+  int64_t index) {
+  assert(buffer);
+  pthread_mutex_lock(&buffer->can_access_slots);
+  while (index >= buffer->flushed_count + buffer->capacity) {
+    ++buffer->waiting_count;
+    pthread_cond_wait(&buffer->has_room, &buffer->can_access_slots);
+    --buffer->waiting_count;
+  }
+  pthread_mutex_unlock(&buffer->can_access_slots);
+}
+
+void goldbach_reorder_buffer_wait_flushed(goldbach_reorder_buffer_t* buffer,
+  int64_t count) {
+  assert(buffer);
+  pthread_mutex_lock(&buffer->can_access_slots);
+  while (buffer->flushed_count < count) {
+    ++buffer->waiting_count;
+    pthread_cond_wait(&buffer->has_room, &buffer->can_access_slots);
+    --buffer->waiting_count;
+  }
+  pthread_mutex_unlock(&buffer->can_access_slots);
+}
+
+void goldbach_reorder_buffer_publish(goldbach_reorder_buffer_t* buffer,
+  int64_t index) {
+  assert(buffer);
+  pthread_mutex_lock(&buffer->can_access_slots);
+  assert(index >= buffer->flushed_count);
+  assert(index < buffer->flushed_count + buffer->capacity);
+  buffer->finished[index % buffer->capacity] = index + 1;
+  // The writer only waits for the number after the prefix
+  if (index == buffer->flushed_count) {
+    pthread_cond_signal(&buffer->has_finished);
+  }
+  pthread_mutex_unlock(&buffer->can_access_slots);
+}
+
+void goldbach_reorder_buffer_close(goldbach_reorder_buffer_t* buffer,
+  int64_t count) {
+  assert(buffer);
+  pthread_mutex_lock(&buffer->can_access_slots);
+  buffer->count = count;
+  buffer->is_closed = true;
+  pthread_cond_signal(&buffer->has_finished);
+  pthread_mutex_unlock(&buffer->can_access_slots);
+}
+
+bool goldbach_reorder_buffer_can_take(goldbach_reorder_buffer_t* buffer) {
+  const int64_t index = buffer->flushed_count;
+  return buffer->finished[index % buffer->capacity] == index + 1
+    || (buffer->is_closed && index >= buffer->count);
+}
+
+bool goldbach_reorder_buffer_is_ready(goldbach_reorder_buffer_t* buffer) {
+  assert(buffer);
+  pthread_mutex_lock(&buffer->can_access_slots);
+  const bool is_ready = goldbach_reorder_buffer_can_take(buffer);
+  pthread_mutex_unlock(&buffer->can_access_slots);
+  return is_ready;
+}
+
+int64_t goldbach_reorder_buffer_next(goldbach_reorder_buffer_t* buffer) {
+  assert(buffer);
+  pthread_mutex_lock(&buffer->can_access_slots);
+  while (!goldbach_reorder_buffer_can_take(buffer)) {
+    // The number could be handed out by a thread waiting for room
+    if (buffer->waiting_count > 0) {
+      pthread_cond_broadcast(&buffer->has_room);
+    }
+    pthread_cond_wait(&buffer->has_finished, &buffer->can_access_slots);
+  }
+  const int64_t index = buffer->flushed_count;
+  const bool is_finished = buffer->finished[index % buffer->capacity]
+    == index + 1;
+  pthread_mutex_unlock(&buffer->can_access_slots);
+  return is_finished ? index : -1;
+}
+
+void goldbach_reorder_buffer_advance(goldbach_reorder_buffer_t* buffer) {
+  assert(buffer);
+  pthread_mutex_lock(&buffer->can_access_slots);
+  ++buffer->flushed_count;
+  if (buffer->waiting_count > 0 && buffer->flushed_count % (buffer->capacity
+    / GOLDBACH_REORDER_BUFFER_WAKE_FRACTION + 1) == 0) {
+    pthread_cond_broadcast(&buffer->has_room);
+  }
+  pthread_mutex_unlock(&buffer->can_access_slots);
+}
+
+int64_t goldbach_reorder_buffer_get_distance(
+  goldbach_reorder_buffer_t* buffer, int64_t index) {
+  assert(buffer);
+  pthread_mutex_lock(&buffer->can_access_slots);
+  const int64_t distance = index - buffer->flushed_count;
+  pthread_mutex_unlock(&buffer->can_access_slots);
+  return distance;
+}
@@ -0,0 +1,133 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_REORDER_BUFFER_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_REORDER_BUFFER_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Default numbers that can be handed out ahead of the printed ones
+#define GOLDBACH_REORDER_BUFFER_WINDOW 1024
+/// The threads waiting for room are woken up when this part of the window,
+/// or more, is free
+#define GOLDBACH_REORDER_BUFFER_WAKE_FRACTION 8
+
+/**
+ * @brief publishes the finished numbers to be printed in the input order.
+ * @details the numbers finish in any order and the writer takes the longest
+ * prefix of finished numbers, prints them and frees their results. A number
+ * can only be handed out while it is inside of the window that follows the
+ * printed prefix, so at most capacity numbers keep their results in memory.
+ * Every slot of the ring stores the index plus one of the last number that
+ * finished in it, so slots are never cleared.
+ */
+typedef struct goldbach_reorder_buffer {
+  /// Size of the window, amount of slots of the ring
+  int64_t capacity;
+  /// Index plus one of the number that finished in every slot
+  int64_t* finished;
+  pthread_mutex_t can_access_slots;
+  /// Signaled when the next number of the prefix finishes or the input ends
+  pthread_cond_t has_finished;
+  /// Broadcast when the writer frees a part of the window or waits
+  pthread_cond_t has_room;
+  /// Threads waiting for room in the window
+  int64_t waiting_count;
+  /// Numbers of the prefix that were printed and freed
+  int64_t flushed_count;
+  /// Amount of numbers of the input, known when the buffer is closed
+  int64_t count;
+  bool is_closed;
+} goldbach_reorder_buffer_t;
+
+/**
+ * @brief initialize the goldbach_reorder_buffer struct.
+ * @param buffer pointer to the buffer to be initialized.
+ * @param capacity numbers that can be handed out ahead of the printed ones.
+ * @return an integer to check errors.
+ */
+int goldbach_reorder_buffer_init(goldbach_reorder_buffer_t* buffer,
+  int64_t capacity);
+
+/**
+ * @brief destroys the goldbach_reorder_buffer struct.
+ * @param buffer pointer to the buffer to be destroyed.
+ */
+void goldbach_reorder_buffer_destroy(goldbach_reorder_buffer_t* buffer);
+
+/**
+ * @brief waits until a number is inside of the window.
+ * @details called before the number is handed out. Numbers must be reserved
+ * in ascending order, or the window must cover every number, otherwise the
+ * writer could wait for a number that is never handed out. The waiting
+ * threads are not woken up for every printed number, but when
+ * 1/GOLDBACH_REORDER_BUFFER_WAKE_FRACTION of the window is free or when the
+ * writer waits, so they calculate several numbers every time.
+ * @param buffer pointer to the buffer.
+ * @param index index of the number.
+ */
+void goldbach_reorder_buffer_reserve(goldbach_reorder_buffer_t* buffer,
+  int64_t index);
+
+/**
+ * @brief waits until the writer printed an amount of numbers.
+ * @details the numbers before it are finished, so no consumer uses the data
+ * shared to calculate them.
+ * @param buffer pointer to the buffer.
+ * @param count amount of numbers of the prefix.
+ */
+void goldbach_reorder_buffer_wait_flushed(goldbach_reorder_buffer_t* buffer,
+  int64_t count);
+
+/**
+ * @brief tells the writer that every unit of a number is finished.
+ * @details this subroutine is thread-safe.
+ * @param buffer pointer to the buffer.
+ * @param index index of the number.
+ */
+void goldbach_reorder_buffer_publish(goldbach_reorder_buffer_t* buffer,
+  int64_t index);
+
+/**
+ * @brief tells the writer the amount of numbers of the input.
+ * @param buffer pointer to the buffer.
+ * @param count amount of numbers.
+ */
+void goldbach_reorder_buffer_close(goldbach_reorder_buffer_t* buffer,
+  int64_t count);
+
+/**
+ * @brief returns if the next number of the prefix can be taken at once.
+ * @param buffer pointer to the buffer.
+ * @return true if goldbach_reorder_buffer_next() would not block.
+ */
+bool goldbach_reorder_buffer_is_ready(goldbach_reorder_buffer_t* buffer);
+
+/**
+ * @brief waits until the number after the printed prefix finishes.
+ * @details only called by the writer.
+ * @param buffer pointer to the buffer.
+ * @return the index of the number, or -1 if every number was printed.
+ */
+int64_t goldbach_reorder_buffer_next(goldbach_reorder_buffer_t* buffer);
+
+/**
+ * @brief frees the slot of the number returned by the last next().
+ * @details called by the writer after the number is printed and its results
+ * are freed.
+ * @param buffer pointer to the buffer.
+ */
+void goldbach_reorder_buffer_advance(goldbach_reorder_buffer_t* buffer);
+
+/**
+ * @brief returns how far a number is from the writer.
+ * @details this subroutine is thread-safe.
+ * @param buffer pointer to the buffer.
+ * @param index index of a number that is not printed.
+ * @return the amount of numbers between the printed prefix and the number.
+ */
+int64_t goldbach_reorder_buffer_get_distance(
+  goldbach_reorder_buffer_t* buffer, int64_t index);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_REORDER_BUFFER_H
@@ -0,0 +1,182 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "goldbach_split.h"
+
+/**
+ * @brief joins the sums of every part in the array of the number.
+ * @details the chunks of the parts are moved in the order of their ranges.
+ * @param split pointer to the split, every part is finished.
+ * @param goldbach_sums array of the sums of the number.
+ */
+void goldbach_split_join(goldbach_split_t* split,
+  goldbach_sums_array_t* goldbach_sums);
+
+/**
+ * @brief returns the addend after the last addend that has work.
+ * @param number positive number.
+ * @return half of the number for even numbers, a third for odd ones.
+ */
+int64_t goldbach_split_end(int64_t number);
+
+int64_t goldbach_split_choose_part_count(double cost, int64_t thread_count) {
+  if (thread_count < 2) {
+    return 1;
+  }
+  int64_t part_count = (int64_t)(cost / GOLDBACH_SPLIT_PART_COST);
+  if (part_count > GOLDBACH_SPLIT_PARTS_PER_THREAD * thread_count) {
+    part_count = GOLDBACH_SPLIT_PARTS_PER_THREAD * thread_count;
+  }
+  return part_count > 1 ? part_count : 1;
+}
+
+void goldbach_split_range(int64_t number, int64_t part, int64_t part_count,
+  int64_t* start, int64_t* finish) {
+  assert(start);
+  assert(finish);
+  assert(part >= 0 && part < part_count);
+  // The first and the last parts cover every addend out of the splits. The
+  // end is used instead of number + 1, which overflows for INT64_MAX
+  *start = 0;
+  *finish = goldbach_split_end(number);
+  if (number % 2 == 0) {
+    const int64_t half = number / 2;
+    // Divided first, so half * part does not overflow for huge numbers
+    if (part > 0) {
+      *start = half / part_count * part + half % part_count * part
+        / part_count;
+    }
+    if (part + 1 < part_count) {
+      *finish = half / part_count * (part + 1) + half % part_count
+        * (part + 1) / part_count;
+    }
+  } else {
+    const double third = number / 3.0;
+    if (part > 0) {
+      *start = (int64_t)(third * (1.0 - sqrt(1.0 - (double)part
+        / part_count)));
+    }
+    if (part + 1 < part_count) {
+      *finish = (int64_t)(third * (1.0 - sqrt(1.0 - (double)(part + 1)
+        / part_count)));
+    }
+  }
+}
+
+/**
+ * @brief returns the share of the work of a number before an addend.
+ * @param number positive number.
+ * @param addend the addend, from 0 to goldbach_split_end().
+ * @return the share, from 0 to 1.
+ */
+double goldbach_split_work(int64_t number, int64_t addend);
+
+int64_t goldbach_split_end(int64_t number) {
+  return number % 2 == 0 ? number / 2 + 1 : number / 3 + 1;
+}
+
+double goldbach_split_work(int64_t number, int64_t addend) {
+  const int64_t end = goldbach_split_end(number);
+  const double position = addend < end ? (double)addend / end : 1.0;
+  // The work per addend of odd numbers decreases linearly
+  return number % 2 == 0 ? position : 1.0 - (1.0 - position)
+    * (1.0 - position);
+}
+
+double goldbach_split_share(int64_t number, int64_t start, int64_t finish) {
+  return goldbach_split_work(number, finish)
+    - goldbach_split_work(number, start);
+}
+
+int64_t goldbach_split_cut(int64_t number, int64_t start, int64_t finish,
+  double fraction) {
+  const int64_t end = goldbach_split_end(number);
+  double work = goldbach_split_work(number, start)
+    + fraction * goldbach_split_share(number, start, finish);
+  work = work < 1.0 ? work : 1.0;
+  const int64_t cut = number % 2 == 0 ? (int64_t)ceil(work * end)
+    : (int64_t)ceil(end * (1.0 - sqrt(1.0 - work)));
+  // Both parts must have at least one addend with work
+  if (cut <= start || cut >= finish || cut >= end) {
+    return finish;
+  }
+  return cut;
+}
+
+int goldbach_split_init(goldbach_split_t* split, int64_t part_count) {
+  assert(split);
+  split->part_count = part_count;
+  split->first_unit = 0;
+  split->parts = NULL;
+  atomic_init(&split->pending_count, part_count);
+  return pthread_mutex_init(&split->can_access_parts, NULL);
+}
+
+void goldbach_split_destroy(goldbach_split_t* split) {
+  assert(split);
+  while (split->parts) {
+    goldbach_part_t* part = split->parts;
+    split->parts = part->next;
+    goldbach_sums_array_destroy(&part->sums);
+    free(part);
+  }
+  pthread_mutex_destroy(&split->can_access_parts);
+}
+
+void goldbach_split_add_part(goldbach_split_t* split) {
+  assert(split);
+  atomic_fetch_add_explicit(&split->pending_count, 1, memory_order_relaxed);
+}
+
+goldbach_part_t* goldbach_split_create_part(int64_t number, int64_t start) {
+  goldbach_part_t* part = (goldbach_part_t*) calloc(1,
+    sizeof(goldbach_part_t));
+  if (part) {
+    part->start = start;
+    part->next = NULL;
+    goldbach_sums_array_init(&part->sums, number);
+  }
+  return part;
+}
+
+int goldbach_split_finish_part(goldbach_split_t* split, goldbach_part_t* part,
+  goldbach_sums_array_t* goldbach_sums, bool* is_joined) {
+  assert(split);
+  assert(is_joined);
+  *is_joined = false;
+  if (part) {
+    pthread_mutex_lock(&split->can_access_parts);
+    // Insert the part sorted by the start of its range
+    goldbach_part_t** position = &split->parts;
+    while (*position && (*position)->start < part->start) {
+      position = &(*position)->next;
+    }
+    part->next = *position;
+    *position = part;
+    pthread_mutex_unlock(&split->can_access_parts);
+  }
+
+  // The thread of the last part sees the parts inserted by the others
+  if (atomic_fetch_sub_explicit(&split->pending_count, 1,
+    memory_order_acq_rel) == 1) {
+    *is_joined = true;
+    goldbach_split_join(split, goldbach_sums);
+  }
+  return EXIT_SUCCESS;
+}
+
+void goldbach_split_join(goldbach_split_t* split,
+  goldbach_sums_array_t* goldbach_sums) {
+  pthread_mutex_lock(&split->can_access_parts);
+  while (split->parts) {
+    goldbach_part_t* part = split->parts;
+    split->parts = part->next;
+    goldbach_sums_array_append_array(goldbach_sums, &part->sums);
+    goldbach_sums_array_destroy(&part->sums);
+    free(part);
+  }
+  pthread_mutex_unlock(&split->can_access_parts);
+}
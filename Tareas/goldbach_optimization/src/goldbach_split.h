@@ -0,0 +1,139 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_SPLIT_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_SPLIT_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "goldbach_sums_array.h"
+
+/// Estimated operations of a part, smaller numbers are not split
+#define GOLDBACH_SPLIT_PART_COST (INT64_C(1) << 16)
+/// Parts of a number per thread, extra parts balance uneven ranges
+#define GOLDBACH_SPLIT_PARTS_PER_THREAD 4
+
+/**
+ * @brief sums of a range of smallest addends of a number.
+ */
+typedef struct goldbach_part {
+  /// Smallest addend where the range of the part starts
+  int64_t start;
+  goldbach_sums_array_t sums;
+  struct goldbach_part* next;
+} goldbach_part_t;
+
+/**
+ * @brief a number whose sums are calculated by parts.
+ * @details every part covers a range of the smallest addend of the sums, so
+ * the sums of the number are the sums of the parts in ascending order of
+ * their ranges. The thread that finishes the last part joins them.
+ */
+typedef struct goldbach_split {
+  /// Amount of parts planned for the number, 1 if it is not split
+  int64_t part_count;
+  /// Position of the first part of the number among the units of every number
+  int64_t first_unit;
+  pthread_mutex_t can_access_parts;
+  /// Finished parts, sorted by the start of their ranges
+  goldbach_part_t* parts;
+  /// Parts that have not finished
+  atomic_int_fast64_t pending_count;
+} goldbach_split_t;
+
+/**
+ * @brief returns in how many parts the sums of a number should be calculated.
+ * @details gives every part at least GOLDBACH_SPLIT_PART_COST operations.
+ * @param cost estimated operations of the number, see goldbach_cost.h.
+ * @param thread_count amount of threads that calculate the sums.
+ * @return the amount of parts, 1 if the number is not worth splitting.
+ */
+int64_t goldbach_split_choose_part_count(double cost, int64_t thread_count);
+
+/**
+ * @brief returns the range of smallest addends of one part of a number.
+ * @details the ranges of even numbers have the same length. The work of a
+ * smallest addend p of an odd number decreases linearly until p = n / 3, so
+ * the range of part k starts at n / 3 * (1 - sqrt(1 - k / part_count)) to
+ * give every part the same work.
+ * @param number positive number.
+ * @param part the part, from 0 to part_count - 1.
+ * @param part_count amount of parts of the number.
+ * @param start smallest addend where the range starts.
+ * @param finish smallest addend where the next range starts.
+ */
+void goldbach_split_range(int64_t number, int64_t part, int64_t part_count,
+  int64_t* start, int64_t* finish);
+
+/**
+ * @brief returns the share of the work of a number in a range of addends.
+ * @details uses the same model than goldbach_split_range().
+ * @param number positive number.
+ * @param start smallest addend where the range starts.
+ * @param finish smallest addend where the next range starts.
+ * @return the share, from 0 to 1.
+ */
+double goldbach_split_share(int64_t number, int64_t start, int64_t finish);
+
+/**
+ * @brief returns where a range of addends should be cut.
+ * @details the part of the range before the cut has a fraction of its work.
+ * @param number positive number.
+ * @param start smallest addend where the range starts.
+ * @param finish smallest addend where the next range starts.
+ * @param fraction fraction of the work before the cut, from 0 to 1.
+ * @return the smallest addend where the second part starts, or finish if
+ * the range can not be cut.
+ */
+int64_t goldbach_split_cut(int64_t number, int64_t start, int64_t finish,
+  double fraction);
+
+/**
+ * @brief initialize the goldbach_split struct.
+ * @param split pointer to the split to be initialized.
+ * @param part_count amount of parts planned for the number.
+ * @return an integer to check errors.
+ */
+int goldbach_split_init(goldbach_split_t* split, int64_t part_count);
+
+/**
+ * @brief destroys the goldbach_split struct.
+ * @details frees the parts that were not joined.
+ * @param split pointer to the split to be destroyed.
+ */
+void goldbach_split_destroy(goldbach_split_t* split);
+
+/**
+ * @brief announces a new part of a number that is being calculated.
+ * @details called before a pending part is cut in two, so the number is not
+ * joined until both halves finish.
+ * @param split pointer to the split.
+ */
+void goldbach_split_add_part(goldbach_split_t* split);
+
+/**
+ * @brief creates an empty part for a range of a number.
+ * @param number the number, negative if its sums are listed.
+ * @param start smallest addend where the range of the part starts.
+ * @return the part, or NULL if it could not be allocated.
+ */
+goldbach_part_t* goldbach_split_create_part(int64_t number, int64_t start);
+
+/**
+ * @brief adds a finished part to the split.
+ * @details if it was the last pending part, the sums of every part are
+ * appended to the array of the number in ascending order of their ranges.
+ * This subroutine is thread-safe.
+ * @param split pointer to the split.
+ * @param part the finished part, the split takes its ownership. NULL if the
+ * part could not be allocated, then it only counts as finished.
+ * @param goldbach_sums array of the sums of the number.
+ * @param is_joined set to true if this call joined the parts.
+ * @return an integer to check errors.
+ */
+int goldbach_split_finish_part(goldbach_split_t* split, goldbach_part_t* part,
+  goldbach_sums_array_t* goldbach_sums, bool* is_joined);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_SPLIT_H
@@ -0,0 +1,105 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "goldbach_stream.h"
+
+/**
+ * @brief destroys the results of an entry.
+ * @param entry pointer to the entry.
+ */
+void goldbach_stream_destroy_entry(goldbach_stream_entry_t* entry);
+
+int goldbach_stream_init(goldbach_stream_t* stream) {
+  assert(stream);
+  stream->count = 0;
+  stream->released_count = 0;
+  atomic_init(&stream->has_failed, false);
+  stream->blocks = (_Atomic(goldbach_stream_block_t*)*) calloc(
+    (size_t)GOLDBACH_STREAM_MAX_BLOCKS,
+    sizeof(_Atomic(goldbach_stream_block_t*)));
+  return stream->blocks ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void goldbach_stream_destroy(goldbach_stream_t* stream) {
+  assert(stream);
+  if (stream->blocks) {
+    while (stream->released_count < stream->count) {
+      goldbach_stream_release(stream);
+    }
+    // The block of the last entries is not full
+    for (int64_t block = stream->count / GOLDBACH_STREAM_BLOCK_ENTRIES;
+      block < GOLDBACH_STREAM_MAX_BLOCKS; ++block) {
+      goldbach_stream_block_t* last_block = atomic_load(&stream->blocks[block]);
+      if (last_block == NULL) {
+        break;
+      }
+      free(last_block);
+    }
+    free(stream->blocks);
+    stream->blocks = NULL;
+  }
+}
+
+int64_t goldbach_stream_append(goldbach_stream_t* stream, int64_t number,
+  int64_t part_count) {
+  assert(stream);
+  // Only the reader changes the count
+  const int64_t index = stream->count;
+  const int64_t block = index / GOLDBACH_STREAM_BLOCK_ENTRIES;
+  if (block >= GOLDBACH_STREAM_MAX_BLOCKS) {
+    atomic_store(&stream->has_failed, true);
+    return -1;
+  }
+  if (index % GOLDBACH_STREAM_BLOCK_ENTRIES == 0) {
+    goldbach_stream_block_t* new_block = (goldbach_stream_block_t*)
+      calloc(1, sizeof(goldbach_stream_block_t));
+    if (new_block == NULL) {
+      atomic_store(&stream->has_failed, true);
+      return -1;
+    }
+    atomic_store_explicit(&stream->blocks[block], new_block,
+      memory_order_release);
+  }
+
+  goldbach_stream_entry_t* entry = goldbach_stream_get(stream, index);
+  if (goldbach_sums_array_init(&entry->sums, number) != EXIT_SUCCESS) {
+    atomic_store(&stream->has_failed, true);
+    return -1;
+  }
+  if (goldbach_split_init(&entry->split, part_count) != EXIT_SUCCESS) {
+    goldbach_sums_array_destroy(&entry->sums);
+    atomic_store(&stream->has_failed, true);
+    return -1;
+  }
+  ++stream->count;
+  return index;
+}
+
+goldbach_stream_entry_t* goldbach_stream_get(goldbach_stream_t* stream,
+  int64_t index) {
+  assert(stream);
+  goldbach_stream_block_t* block = atomic_load_explicit(
+    &stream->blocks[index / GOLDBACH_STREAM_BLOCK_ENTRIES],
+    memory_order_acquire);
+  assert(block);
+  return &block->entries[index % GOLDBACH_STREAM_BLOCK_ENTRIES];
+}
+
+void goldbach_stream_release(goldbach_stream_t* stream) {
+  assert(stream);
+  const int64_t index = stream->released_count++;
+  goldbach_stream_destroy_entry(goldbach_stream_get(stream, index));
+  // The last entry of a block frees the block
+  if ((index + 1) % GOLDBACH_STREAM_BLOCK_ENTRIES == 0) {
+    const int64_t block = index / GOLDBACH_STREAM_BLOCK_ENTRIES;
+    free(atomic_load(&stream->blocks[block]));
+    atomic_store(&stream->blocks[block], NULL);
+  }
+}
+
+void goldbach_stream_destroy_entry(goldbach_stream_entry_t* entry) {
+  goldbach_sums_array_destroy(&entry->sums);
+  goldbach_split_destroy(&entry->split);
+}
@@ -0,0 +1,91 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_STREAM_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_STREAM_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "goldbach_split.h"
+#include "goldbach_sums_array.h"
+
+/// Entries of every block of the stream
+#define GOLDBACH_STREAM_BLOCK_ENTRIES (INT64_C(1) << 12)
+/// Blocks that the stream can address, 2^30 numbers
+#define GOLDBACH_STREAM_MAX_BLOCKS (INT64_C(1) << 18)
+
+/**
+ * @brief a number read from the input and its results.
+ */
+typedef struct goldbach_stream_entry {
+  goldbach_sums_array_t sums;
+  goldbach_split_t split;
+} goldbach_stream_entry_t;
+
+typedef struct goldbach_stream_block {
+  goldbach_stream_entry_t entries[GOLDBACH_STREAM_BLOCK_ENTRIES];
+} goldbach_stream_block_t;
+
+/**
+ * @brief numbers that are calculated while the input is being read.
+ * @details the reader appends the numbers and the consumers calculate them
+ * in any order, see goldbach_reorder_buffer.h for the order of the output.
+ * The entries are stored in blocks that never move, so consumers use them
+ * while the reader appends more, and the writer frees a block when every
+ * entry of it is printed.
+ */
+typedef struct goldbach_stream {
+  /// Blocks of entries, NULL when they are not created or already freed
+  _Atomic(goldbach_stream_block_t*)* blocks;
+  /// Amount of numbers read, only used by the reader
+  int64_t count;
+  /// Numbers whose results were printed and freed, only used by the writer
+  int64_t released_count;
+  /// Set when an entry could not be allocated
+  atomic_bool has_failed;
+} goldbach_stream_t;
+
+/**
+ * @brief initialize the goldbach_stream struct.
+ * @param stream pointer to the stream to be initialized.
+ * @return an integer to check errors.
+ */
+int goldbach_stream_init(goldbach_stream_t* stream);
+
+/**
+ * @brief destroys the goldbach_stream struct.
+ * @details frees the entries that were not released.
+ * @param stream pointer to the stream to be destroyed.
+ */
+void goldbach_stream_destroy(goldbach_stream_t* stream);
+
+/**
+ * @brief adds a number read from the input.
+ * @details only called by the reader.
+ * @param stream pointer to the stream.
+ * @param number the number.
+ * @param part_count amount of parts of the number.
+ * @return the index of the number, or -1 if it could not be allocated.
+ */
+int64_t goldbach_stream_append(goldbach_stream_t* stream, int64_t number,
+  int64_t part_count);
+
+/**
+ * @brief returns the entry of a number that was appended.
+ * @param stream pointer to the stream.
+ * @param index index of the number, not released.
+ * @return the entry.
+ */
+goldbach_stream_entry_t* goldbach_stream_get(goldbach_stream_t* stream,
+  int64_t index);
+
+/**
+ * @brief frees the results of the next number of the input.
+ * @details only called by the writer after the number is printed. The block
+ * is freed with its last entry.
+ * @param stream pointer to the stream.
+ */
+void goldbach_stream_release(goldbach_stream_t* stream);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_GOLDBACH_STREAM_H
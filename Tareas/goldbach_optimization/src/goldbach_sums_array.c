@@ -11,30 +11,75 @@
 int64_t get_amount_sums(goldbach_sums_array_t* array);
 
 /**
- * @brief increases the capacity of the goldbach_sums_array struct.
- * @details increases the capacity of the goldbach_sums_array struct by making it
- * 10 times bigger.
+ * @brief adds an empty chunk at the end of the array.
+ * @details the chunk is of the next class of the last chunk, up to the
+ * biggest class, so a number with many sums takes few chunks.
  * @param array pointer to the array.
  * @return returns an integer to check errors.
  */
-int goldbach_sums_array_increase_capacity(goldbach_sums_array_t* array);
+int goldbach_sums_array_add_chunk(goldbach_sums_array_t* array);
+
+/**
+ * @brief returns the amount of free addends that fit in a chunk.
+ * @param array pointer to the array.
+ * @param chunk a chunk of the array.
+ * @return the amount of free addends.
+ */
+int64_t goldbach_sums_array_chunk_capacity(const goldbach_sums_array_t* array,
+  const goldbach_arena_chunk_t* chunk);
+
+/**
+ * @brief returns a free addend stored in a chunk.
+ * @param array pointer to the array.
+ * @param chunk a chunk of the array.
+ * @param index position of the addend in the chunk.
+ * @return the addend.
+ */
+int64_t goldbach_sums_array_get(const goldbach_sums_array_t* array,
+  const goldbach_arena_chunk_t* chunk, int64_t index);
+
+/**
+ * @brief writes the text of one sum of the number.
+ * @details the last addend is the number minus the free ones.
+ * @param array pointer to the array.
+ * @param chunk chunk where the sum is stored.
+ * @param index position of the first free addend of the sum in the chunk.
+ * @param amount_addends amount of addends that the sum has.
+ * @param bytes where the text is written, with room for
+ * GOLDBACH_SUMS_ARRAY_SUM_BYTES bytes.
+ * @return the amount of bytes written.
+ */
+size_t goldbach_sums_array_format_sum(const goldbach_sums_array_t* array,
+  const goldbach_arena_chunk_t* chunk, int64_t index, int64_t amount_addends,
+  char* bytes);
+
+/**
+ * @brief gives every chunk of a list back to its arena.
+ * @param chunk first chunk of the list.
+ */
+void goldbach_sums_array_give_back(goldbach_arena_chunk_t* chunk);
 
 /**
  * @brief prints one sum of the number.
  * @details checks if the addends should be 2 or 3, then prints one 
  * sum of the number.
  * @param array pointer to the array.
- * @param index_array index of the array were the sum starts.
+ * @param chunk chunk where the sum is stored.
+ * @param index position of the first free addend of the sum in the chunk.
  * @param amount_addends amount of addends that the sum has.
+ * @param output where the sum is printed.
  */
-void print_sum(goldbach_sums_array_t* array, int64_t index_array,
-  int64_t amount_addends);
+void print_sum(const goldbach_sums_array_t* array,
+  const goldbach_arena_chunk_t* chunk, int64_t index, int64_t amount_addends,
+  goldbach_output_t* output);
 
 int goldbach_sums_array_init(goldbach_sums_array_t* array, int64_t number) {
   assert(array);
-  array->capacity = 0;
   array->count = 0;
-  array->elements = NULL;
+  array->first_chunk = NULL;
+  array->last_chunk = NULL;
+  array->arena = NULL;
+  array->sum_count = 0;
   array->number = number;
   array->is_negative_number = false;
 
@@ -42,101 +87,263 @@ int goldbach_sums_array_init(goldbach_sums_array_t* array, int64_t number) {
     array->number = number * (-1);
     array->is_negative_number = true;
   }
+  // Every addend is smaller than the number
+  array->is_narrow = array->number <= UINT32_MAX;
 
   return EXIT_SUCCESS;
 }
 
 void goldbach_sums_array_destroy(goldbach_sums_array_t* array) {
   assert(array);
-  array->capacity = 0;
   array->count = 0;
+  array->sum_count = 0;
   array->number = 0;
   array->is_negative_number = false;
-  free(array->elements);
+  goldbach_sums_array_give_back(array->first_chunk);
+  array->first_chunk = NULL;
+  array->last_chunk = NULL;
 }
 
-int goldbach_sums_array_append(goldbach_sums_array_t* array, int64_t element) {
-  assert(array);
-  if (element < 0) {
-    element *= -1;
-    array->is_negative_number = true;
+void goldbach_sums_array_give_back(goldbach_arena_chunk_t* chunk) {
+  while (chunk) {
+    goldbach_arena_chunk_t* next = chunk->next;
+    goldbach_arena_give_back(chunk);
+    chunk = next;
   }
-  if (array->count == array->capacity) {
-    if (goldbach_sums_array_increase_capacity(array) != EXIT_SUCCESS) {
+}
+
+int goldbach_sums_array_append_sum(goldbach_sums_array_t* array,
+  const int64_t* addends, int64_t addend_count) {
+  assert(array);
+  assert(addends);
+  // The last addend is implied by the others
+  const int64_t free_count = addend_count - 1;
+  goldbach_arena_chunk_t* chunk = array->last_chunk;
+  if (chunk == NULL || chunk->count + free_count
+    > goldbach_sums_array_chunk_capacity(array, chunk)) {
+    if (goldbach_sums_array_add_chunk(array) != EXIT_SUCCESS) {
       return EXIT_FAILURE;
     }
+    chunk = array->last_chunk;
+  }
+  if (array->is_narrow) {
+    uint32_t* elements = (uint32_t*)chunk->elements;
+    for (int64_t index = 0; index < free_count; ++index) {
+      elements[chunk->count++] = (uint32_t)addends[index];
+    }
+  } else {
+    for (int64_t index = 0; index < free_count; ++index) {
+      chunk->elements[chunk->count++] = addends[index];
+    }
   }
-  array->elements[array->count++] = element;
+  array->count += free_count;
+  ++array->sum_count;
   return EXIT_SUCCESS;
 }
 
-int goldbach_sums_array_increase_capacity(goldbach_sums_array_t* array) {
-  int64_t new_capacity = 10 * (array->capacity ? array->capacity : 1);
-  int64_t* new_elements = (int64_t*)
-    realloc(array->elements, new_capacity * sizeof(int64_t));
+void goldbach_sums_array_add_count(goldbach_sums_array_t* array,
+  int64_t sum_count) {
+  assert(array);
+  array->sum_count += sum_count;
+}
 
-  if (new_elements) {
-    array->capacity = new_capacity;
-    array->elements = new_elements;
+void goldbach_sums_array_append_array(goldbach_sums_array_t* array,
+  goldbach_sums_array_t* other) {
+  assert(array);
+  assert(other);
+  if (other->first_chunk) {
+    if (array->last_chunk) {
+      array->last_chunk->next = other->first_chunk;
+    } else {
+      array->first_chunk = other->first_chunk;
+    }
+    array->last_chunk = other->last_chunk;
+  }
+  array->count += other->count;
+  array->sum_count += other->sum_count;
+  other->first_chunk = NULL;
+  other->last_chunk = NULL;
+  other->count = 0;
+  other->sum_count = 0;
+}
+
+int goldbach_sums_array_reserve(goldbach_sums_array_t* array,
+  int64_t sum_count) {
+  assert(array);
+  if (sum_count <= 0) {
     return EXIT_SUCCESS;
+  }
+  // Free addends of the sums, in elements of 64 bits
+  int64_t capacity = array->number % 2 == 0 ? sum_count : 2 * sum_count;
+  if (array->is_narrow) {
+    capacity = (capacity + 1) / 2;
+  }
+  goldbach_arena_chunk_t* chunk = goldbach_arena_take_exact(capacity);
+  if (chunk == NULL) {
+    return EXIT_FAILURE;
+  }
+  if (array->last_chunk) {
+    array->last_chunk->next = chunk;
   } else {
+    array->first_chunk = chunk;
+  }
+  array->last_chunk = chunk;
+  return EXIT_SUCCESS;
+}
+
+int goldbach_sums_array_add_chunk(goldbach_sums_array_t* array) {
+  int64_t size_class = 0;
+  if (array->last_chunk) {
+    size_class = array->last_chunk->size_class + 1;
+    if (size_class >= GOLDBACH_ARENA_CLASS_COUNT) {
+      size_class = GOLDBACH_ARENA_CLASS_COUNT - 1;
+    }
+  }
+  goldbach_arena_chunk_t* chunk = goldbach_arena_take(array->arena,
+    size_class);
+  if (chunk == NULL) {
     return EXIT_FAILURE;
   }
+  if (array->last_chunk) {
+    array->last_chunk->next = chunk;
+  } else {
+    array->first_chunk = chunk;
+  }
+  array->last_chunk = chunk;
+  return EXIT_SUCCESS;
 }
 
-int64_t get_amount_sums(goldbach_sums_array_t* array) {
-  int64_t amount_sums = 0;
+int64_t goldbach_sums_array_chunk_capacity(const goldbach_sums_array_t* array,
+  const goldbach_arena_chunk_t* chunk) {
+  return array->is_narrow ? 2 * chunk->capacity : chunk->capacity;
+}
 
-  if (array->number % 2 == 0) {
-    amount_sums = array->count / 2;
-  } else {
-    amount_sums = array->count / 3;
+int64_t goldbach_sums_array_get(const goldbach_sums_array_t* array,
+  const goldbach_arena_chunk_t* chunk, int64_t index) {
+  return array->is_narrow ? ((const uint32_t*)chunk->elements)[index]
+    : chunk->elements[index];
+}
+
+int goldbach_sums_array_render(goldbach_sums_array_t* array) {
+  assert(array);
+  // The sums of positive numbers are not listed
+  if (!array->is_negative_number || array->first_chunk == NULL) {
+    return EXIT_SUCCESS;
   }
-  return amount_sums;
+  const int64_t amount_addends = array->number % 2 == 0 ? 2 : 3;
+  goldbach_arena_chunk_t* first_text = NULL;
+  goldbach_arena_chunk_t* text = NULL;
+  for (const goldbach_arena_chunk_t* chunk = array->first_chunk; chunk;
+    chunk = chunk->next) {
+    for (int64_t index = 0; index < chunk->count;
+      index += amount_addends - 1) {
+      if (text == NULL || (int64_t)sizeof(int64_t) * text->capacity
+        - text->count < GOLDBACH_SUMS_ARRAY_SUM_BYTES) {
+        // The text grows in chunks of growing classes, like the sums
+        int64_t size_class = text ? text->size_class + 1 : 0;
+        if (size_class >= GOLDBACH_ARENA_CLASS_COUNT) {
+          size_class = GOLDBACH_ARENA_CLASS_COUNT - 1;
+        }
+        goldbach_arena_chunk_t* next = goldbach_arena_take(array->arena,
+          size_class);
+        if (next == NULL) {
+          goldbach_sums_array_give_back(first_text);
+          return EXIT_FAILURE;
+        }
+        next->is_text = true;
+        if (text) {
+          text->next = next;
+        } else {
+          first_text = next;
+        }
+        text = next;
+      }
+      char* bytes = (char*)text->elements + text->count;
+      bytes[0] = ',';
+      bytes[1] = ' ';
+      text->count += 2 + (int64_t)goldbach_sums_array_format_sum(array, chunk,
+        index, amount_addends, bytes + 2);
+    }
+  }
+
+  goldbach_sums_array_give_back(array->first_chunk);
+  array->first_chunk = first_text;
+  array->last_chunk = text;
+  array->count = 0;
+  return EXIT_SUCCESS;
 }
 
-void goldbach_sums_array_print(goldbach_sums_array_t* array) {
-  if (array->number < 0 || array->number > 5) {
-    if (!array->is_negative_number) {
-      printf("%"SCNd64 "%s" "%"SCNd64 "%s", array->number, ": " ,
-      get_amount_sums(array), " sums");
+int64_t get_amount_sums(goldbach_sums_array_t* array) {
+  return array->sum_count;
+}
 
+void goldbach_sums_array_print(goldbach_sums_array_t* array,
+  goldbach_output_t* output) {
+  if (array->is_negative_number) {
+    goldbach_output_append(output, "-", 1);
+  }
+  goldbach_output_append_int64(output, array->number);
+  if (array->number > 5) {
+    goldbach_output_append(output, ": ", 2);
+    goldbach_output_append_int64(output, get_amount_sums(array));
+    if (!array->is_negative_number) {
+      goldbach_output_append(output, " sums", 5);
     } else {
-      printf("%s" "%"SCNd64 "%s" "%"SCNd64 "%s", "-", array->number,
-        ": " , get_amount_sums(array), " sums: ");
-
-      if (array->number % 2 == 0) {
-        for (int index = 0; index < array->count; index += 2) {
-          print_sum(array, index, 2);
-          if (index + 2 < array->count) {
-            printf(", ");
-          }
+      goldbach_output_append(output, " sums: ", 7);
+
+      const int64_t amount_addends = array->number % 2 == 0 ? 2 : 3;
+      bool is_first = true;
+      for (const goldbach_arena_chunk_t* chunk = array->first_chunk; chunk;
+        chunk = chunk->next) {
+        if (chunk->is_text) {
+          // The rendered text of every sum starts with its separator
+          const int64_t skipped = is_first ? 2 : 0;
+          goldbach_output_append(output, (const char*)chunk->elements
+            + skipped, (size_t)(chunk->count - skipped));
+          is_first = false;
+          continue;
         }
-      } else {
-        for (int index = 0; index < array->count; index += 3) {
-          print_sum(array, index, 3);
-          if (index + 3 < array->count) {
-            printf(", ");
+        for (int64_t index = 0; index < chunk->count;
+          index += amount_addends - 1) {
+          if (!is_first) {
+            goldbach_output_append(output, ", ", 2);
           }
+          print_sum(array, chunk, index, amount_addends, output);
+          is_first = false;
         }
       }
     }
   } else {
-    if (array->is_negative_number) {
-      printf("%"SCNd64 "%s", -array->number, ": NA");
-    } else {
-      printf("%"SCNd64 "%s", array->number, ": NA");
-    }
+    goldbach_output_append(output, ": NA", 4);
   }
-  printf("%s", "\n");
+  goldbach_output_append(output, "\n", 1);
+}
+
+void print_sum(const goldbach_sums_array_t* array,
+  const goldbach_arena_chunk_t* chunk, int64_t index, int64_t amount_addends,
+  goldbach_output_t* output) {
+  char bytes[GOLDBACH_SUMS_ARRAY_SUM_BYTES];
+  goldbach_output_append(output, bytes, goldbach_sums_array_format_sum(array,
+    chunk, index, amount_addends, bytes));
 }
 
-void print_sum(goldbach_sums_array_t* array, int64_t index_array,
-  int64_t amount_addends) {
-  for (int64_t index = 0; index < amount_addends; index++) {
-    printf("%"SCNd64, array->elements[index_array++]);
-    if (index + 1 < amount_addends) {
-      printf("%s", " + ");
+size_t goldbach_sums_array_format_sum(const goldbach_sums_array_t* array,
+  const goldbach_arena_chunk_t* chunk, int64_t index, int64_t amount_addends,
+  char* bytes) {
+  int64_t addends[3] = {0};
+  addends[amount_addends - 1] = array->number;
+  for (int64_t addend = 0; addend < amount_addends - 1; ++addend) {
+    addends[addend] = goldbach_sums_array_get(array, chunk, index + addend);
+    addends[amount_addends - 1] -= addends[addend];
+  }
+  size_t length = 0;
+  for (int64_t addend = 0; addend < amount_addends; addend++) {
+    length += goldbach_output_format_int64(bytes + length, addends[addend]);
+    if (addend + 1 < amount_addends) {
+      bytes[length++] = ' ';
+      bytes[length++] = '+';
+      bytes[length++] = ' ';
     }
   }
+  return length;
 }
@@ -11,12 +11,35 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "goldbach_arena.h"
+#include "goldbach_output.h"
+
+/// Most bytes of the text of a sum: a separator, three addends and two signs
+#define GOLDBACH_SUMS_ARRAY_SUM_BYTES (2 + 3 * GOLDBACH_OUTPUT_INT64_DIGITS + 6)
+
+/**
+ * @brief goldbach sums of a number.
+ * @details the addends are stored in a list of chunks of growing classes,
+ * so the array grows without copying its elements. Every chunk holds whole
+ * sums. The last addend of a sum is the number minus the others, so only
+ * the free addends are stored: the first one of a pair and the first two of
+ * a trio. They are stored in 32 bits when the number fits in 32 bits.
+ * When the sums are rendered, their chunks are replaced by chunks of text
+ * in the same order.
+ */
 typedef struct goldbach_sums_array {
-  int64_t capacity;
+  /// Amount of free addends of every chunk of sums together
   int64_t count;
-  int64_t* elements;
+  goldbach_arena_chunk_t* first_chunk;
+  goldbach_arena_chunk_t* last_chunk;
+  /// Arena of the thread that appends the sums, NULL to use malloc
+  goldbach_arena_t* arena;
+  /// Amount of sums, positive numbers only count them without elements
+  int64_t sum_count;
   int64_t number;
   bool is_negative_number;
+  /// The free addends are stored as uint32_t instead of int64_t
+  bool is_narrow;
 } goldbach_sums_array_t;
 
 /**
@@ -30,25 +53,76 @@ int goldbach_sums_array_init(goldbach_sums_array_t* array, int64_t number);
 
 /**
  * @brief destroys the goldbach_sums_array struct.
- * @details destroys the goldbach_sums_array struct.
+ * @details gives the chunks back to the arenas that carved them. The array
+ * can be destroyed again.
  * @param array pointer to the array to be destroyed.
  * @return an integer to check errors.
  */
 void goldbach_sums_array_destroy(goldbach_sums_array_t* array);
 
 /**
- * @brief appends an element to the goldbach_sums_array struct.
- * @details appends an element to the goldbach_sums_array struct.
+ * @brief appends a sum to the goldbach_sums_array struct.
+ * @details appends the free addends of the sum and counts the sum.
+ * Takes a chunk of the next class from the arena when the last chunk has no
+ * room for the sum.
  * @param array pointer to the array.
- * @param element element to be Appended.
+ * @param addends addends of the sum, in ascending order.
+ * @param addend_count amount of addends of the sum, 2 or 3.
  * @return an integer to check errors.
  */
-int goldbach_sums_array_append(goldbach_sums_array_t* array, int64_t element);
+int goldbach_sums_array_append_sum(goldbach_sums_array_t* array,
+  const int64_t* addends, int64_t addend_count);
+
+/**
+ * @brief adds a chunk with room for an exact amount of sums.
+ * @details used when the sums are counted before they are appended, so the
+ * appended sums fill one allocation without growing the array.
+ * @param array pointer to the array.
+ * @param sum_count amount of sums that will be appended.
+ * @return an integer to check errors.
+ */
+int goldbach_sums_array_reserve(goldbach_sums_array_t* array,
+  int64_t sum_count);
+
+/**
+ * @brief counts sums without storing their addends.
+ * @details used for positive numbers, whose sums are not printed.
+ * @param array pointer to the array.
+ * @param sum_count amount of sums to be added.
+ */
+void goldbach_sums_array_add_count(goldbach_sums_array_t* array,
+  int64_t sum_count);
+
+/**
+ * @brief moves the sums of another array to the end of an array.
+ * @details used to join the parts of a number calculated by several threads.
+ * The chunks of the other array are linked at the end, without copying
+ * them, and the other array is left empty.
+ * @param array pointer to the array.
+ * @param other pointer to the array whose sums are moved.
+ */
+void goldbach_sums_array_append_array(goldbach_sums_array_t* array,
+  goldbach_sums_array_t* other);
+
+/**
+ * @brief formats the listed sums as text, in a consumer.
+ * @details the text of every sum starts with a separator, which the printer
+ * skips for the first one. The text is written in chunks of the arena of the
+ * array, and the chunks of the sums are given back. Called once, after every
+ * sum of the array is appended.
+ * @param array pointer to the array.
+ * @return an integer to check errors, the sums are kept if the text could
+ * not be allocated.
+ */
+int goldbach_sums_array_render(goldbach_sums_array_t* array);
 
 /**
  * @brief prints the number and/or its goldbach sums.
- * @details prints the number and/or its goldbach sums.
+ * @details copies the rendered text of the sums, and formats the sums that
+ * were not rendered.
  * @param array pointer to the array.
+ * @param output buffer where the text is appended.
  */
-void goldbach_sums_array_print(goldbach_sums_array_t* array);
+void goldbach_sums_array_print(goldbach_sums_array_t* array,
+  goldbach_output_t* output);
 #endif  // TAREAS_GOLDBACH_PTHREAD_GOLDBACH_SUMS_ARRAY_H_
@@ -0,0 +1,133 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <stddef.h>
+
+#include "miller_rabin.h"
+
+typedef unsigned __int128 uint128_t;
+
+/// Odd modulus prepared for Montgomery multiplication, R is 2^64
+typedef struct montgomery {
+  uint64_t modulus;
+  /// -modulus^-1 mod R
+  uint64_t inverse;
+  /// R mod modulus, the Montgomery form of 1
+  uint64_t one;
+} montgomery_t;
+
+/**
+ * @brief prepares the constants to multiply modulo an odd number.
+ * @param montgomery pointer to the struct to be initialized.
+ * @param modulus the odd modulus.
+ */
+static void montgomery_init(montgomery_t* montgomery, uint64_t modulus) {
+  // Newton iteration doubles the correct bits of the inverse every step
+  uint64_t inverse = modulus;
+  for (int step = 0; step < 5; ++step) {
+    inverse *= 2 - modulus * inverse;
+  }
+  montgomery->modulus = modulus;
+  montgomery->inverse = -inverse;
+  montgomery->one = -modulus % modulus;
+}
+
+/**
+ * @brief returns value * R^-1 modulo the modulus.
+ * @param montgomery the prepared modulus.
+ * @param value product smaller than modulus * R.
+ * @return the reduced value, smaller than the modulus.
+ */
+static inline uint64_t montgomery_reduce(const montgomery_t* montgomery,
+  uint128_t value) {
+  const uint64_t factor = (uint64_t)value * montgomery->inverse;
+  const uint128_t sum = value + (uint128_t)factor * montgomery->modulus;
+  // The sum overflows only for moduli bigger than 2^63, then it is reduced
+  const bool carry = sum < value;
+  const uint64_t result = (uint64_t)(sum >> 64);
+  return carry || result >= montgomery->modulus
+    ? result - montgomery->modulus : result;
+}
+
+static inline uint64_t montgomery_multiply(const montgomery_t* montgomery,
+  uint64_t left, uint64_t right) {
+  return montgomery_reduce(montgomery, (uint128_t)left * right);
+}
+
+static inline uint64_t montgomery_convert(const montgomery_t* montgomery,
+  uint64_t value) {
+  return (uint64_t)(((uint128_t)value << 64) % montgomery->modulus);
+}
+
+/**
+ * @brief returns if a witness proves that the number is composite.
+ * @param montgomery the number prepared as modulus.
+ * @param witness the base of the test.
+ * @param odd_part odd number d such that number - 1 = d * 2^shift.
+ * @param shift exponent of 2 in number - 1.
+ * @return true if the number is composite for sure.
+ */
+static bool miller_rabin_is_witness(const montgomery_t* montgomery,
+  uint64_t witness, uint64_t odd_part, int shift) {
+  const uint64_t minus_one = montgomery->modulus - montgomery->one;
+  // power := witness^odd_part in Montgomery form
+  uint64_t base = montgomery_convert(montgomery, witness);
+  uint64_t power = montgomery->one;
+  for (uint64_t exponent = odd_part; exponent; exponent >>= 1) {
+    if (exponent & 1) {
+      power = montgomery_multiply(montgomery, power, base);
+    }
+    base = montgomery_multiply(montgomery, base, base);
+  }
+  if (power == montgomery->one || power == minus_one) {
+    return false;
+  }
+  for (int step = 1; step < shift; ++step) {
+    power = montgomery_multiply(montgomery, power, power);
+    if (power == minus_one) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool miller_rabin_is_prime(uint64_t number) {
+  static const uint64_t small_primes[] = {
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37
+  };
+  // Witnesses without strong liars below 2^64 (Jim Sinclair)
+  static const uint64_t witnesses[] = {
+    2, 325, 9375, 28178, 450775, 9780504, 1795265022
+  };
+
+  if (number < 2) {
+    return false;
+  }
+  for (size_t index = 0; index < sizeof(small_primes) / sizeof(uint64_t);
+    ++index) {
+    if (number % small_primes[index] == 0) {
+      return number == small_primes[index];
+    }
+  }
+  if (number < 41 * 41) {
+    return true;
+  }
+
+  uint64_t odd_part = number - 1;
+  int shift = 0;
+  while ((odd_part & 1) == 0) {
+    odd_part >>= 1;
+    ++shift;
+  }
+  montgomery_t montgomery;
+  montgomery_init(&montgomery, number);
+  for (size_t index = 0; index < sizeof(witnesses) / sizeof(uint64_t);
+    ++index) {
+    const uint64_t witness = witnesses[index] % number;
+    // A multiple of the number does not say anything about it
+    if (witness != 0 && miller_rabin_is_witness(&montgomery, witness,
+      odd_part, shift)) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,19 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_MILLER_RABIN_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_MILLER_RABIN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief returns if a number is a prime number.
+ * @details deterministic Miller-Rabin test for every 64-bit number, it uses
+ * a fixed set of witnesses that has no strong liars below 2^64, and
+ * Montgomery multiplication with 128-bit products.
+ * @param number the number.
+ * @return true if the number is a prime number.
+ */
+bool miller_rabin_is_prime(uint64_t number);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_MILLER_RABIN_H
@@ -0,0 +1,441 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "prime_sieve.h"
+
+/**
+ * @brief creates a snapshot with an unsieved table from 0 to limit.
+ * @param limit biggest number of the table.
+ * @return the snapshot, or NULL if there is not enough memory.
+ */
+prime_sieve_snapshot_t* prime_sieve_snapshot_create(int64_t limit);
+
+/**
+ * @brief frees a snapshot and its table.
+ * @param snapshot pointer to the snapshot, can be NULL.
+ */
+void prime_sieve_snapshot_destroy(prime_sieve_snapshot_t* snapshot);
+
+/**
+ * @brief sieves the next segment of a snapshot that has not been claimed.
+ * @details this subroutine is thread-safe, every segment is claimed by only
+ * one thread.
+ * @param snapshot pointer to the snapshot.
+ * @return false if every segment was already claimed.
+ */
+bool prime_sieve_snapshot_sieve_next(prime_sieve_snapshot_t* snapshot);
+
+/**
+ * @brief waits until the table of a snapshot covers a number.
+ * @details the calling thread sieves the unclaimed segments, or yields if
+ * the other threads are sieving the missing ones.
+ * @param snapshot pointer to the snapshot.
+ * @param number biggest number that will be looked up.
+ */
+void prime_sieve_snapshot_require(prime_sieve_snapshot_t* snapshot,
+  int64_t number);
+
+/**
+ * @brief extends the published prefix over the sieved segments.
+ * @details segments can be sieved out of order, the prefix only grows while
+ * the segment after it is sieved. Only one thread at a time publishes the
+ * segments, the others do not wait for it.
+ * @param snapshot pointer to the snapshot.
+ */
+void prime_sieve_snapshot_publish(prime_sieve_snapshot_t* snapshot);
+
+/**
+ * @brief announces and returns the current snapshot.
+ * @details the current pointer is read again after the announcement, so the
+ * snapshot can not be freed by a reader that is growing the sieve.
+ * @param sieve pointer to the sieve.
+ * @param reader number of the calling reader.
+ * @return the current snapshot.
+ */
+prime_sieve_snapshot_t* prime_sieve_protect(prime_sieve_t* sieve,
+  int64_t reader);
+
+/**
+ * @brief builds and publishes a snapshot that covers a number.
+ * @details must be called only by the reader that set is_growing. The
+ * published segments of the current snapshot are copied and the new
+ * snapshot is published at once, its other segments are sieved by every
+ * reader that needs them, see prime_sieve_snapshot_require().
+ * @param sieve pointer to the sieve.
+ * @param number number that the new snapshot must cover.
+ * @return an integer to check errors.
+ */
+int prime_sieve_grow(prime_sieve_t* sieve, int64_t number);
+
+/**
+ * @brief frees the replaced snapshots that no reader is using.
+ * @details must be called only by the reader that set is_growing.
+ * @param sieve pointer to the sieve.
+ */
+void prime_sieve_reclaim(prime_sieve_t* sieve);
+
+/**
+ * @brief finds the primes that are needed to sieve up to the limit.
+ * @details runs a plain sieve of Eratosthenes from 0 to the square root of
+ * the limit of the table.
+ * @param table pointer to the table that will be sieved.
+ * @param base_primes array where the primes are appended.
+ * @return an integer to check errors.
+ */
+int prime_sieve_find_base_primes(const prime_table_t* table,
+  array_int64_t* base_primes);
+
+/**
+ * @brief crosses out the composite numbers of one segment of the table.
+ * @details marks every odd number of the words [first_word, last_word) as
+ * prime and then crosses out the odd multiples of the base primes.
+ * @param table pointer to the table.
+ * @param base_primes the primes up to the square root of the limit.
+ * @param first_word first word of the segment.
+ * @param last_word first word after the segment.
+ */
+void prime_sieve_sieve_segment(prime_table_t* table,
+  array_int64_t* base_primes, int64_t first_word, int64_t last_word);
+
+/**
+ * @brief clears the bits of the numbers bigger than the limit of the table.
+ * @details the last word of the table can cover numbers after the limit.
+ * @param table pointer to the table.
+ */
+void prime_sieve_clear_tail(prime_table_t* table);
+
+int prime_sieve_init(prime_sieve_t* sieve, int64_t limit,
+  int64_t reader_count) {
+  assert(sieve);
+  assert(reader_count > 0);
+  int error = EXIT_SUCCESS;
+  if (limit < 2) {
+    limit = 2;
+  }
+  if (limit > PRIME_SIEVE_MAX_LIMIT) {
+    limit = PRIME_SIEVE_MAX_LIMIT;
+  }
+  atomic_flag_clear(&sieve->is_growing);
+  sieve->reader_count = reader_count;
+  sieve->retired = NULL;
+  sieve->hazards = (_Atomic(prime_sieve_snapshot_t*)*) calloc(
+    (size_t)reader_count, sizeof(_Atomic(prime_sieve_snapshot_t*)));
+  prime_sieve_snapshot_t* snapshot = prime_sieve_snapshot_create(limit);
+  atomic_init(&sieve->current, snapshot);
+
+  if (sieve->hazards && snapshot) {
+    for (int64_t reader = 0; reader < reader_count; ++reader) {
+      atomic_init(&sieve->hazards[reader], NULL);
+    }
+  } else {
+    error = EXIT_FAILURE;
+    prime_sieve_destroy(sieve);
+  }
+  return error;
+}
+
+void prime_sieve_destroy(prime_sieve_t* sieve) {
+  assert(sieve);
+  prime_sieve_snapshot_destroy(atomic_load(&sieve->current));
+  atomic_store(&sieve->current, NULL);
+  while (sieve->retired) {
+    prime_sieve_snapshot_t* next = sieve->retired->next_retired;
+    prime_sieve_snapshot_destroy(sieve->retired);
+    sieve->retired = next;
+  }
+  free(sieve->hazards);
+  sieve->hazards = NULL;
+  sieve->reader_count = 0;
+}
+
+void prime_sieve_build(prime_sieve_t* sieve) {
+  assert(sieve);
+  prime_sieve_snapshot_t* snapshot = atomic_load(&sieve->current);
+  while (prime_sieve_snapshot_sieve_next(snapshot)) {
+  }
+}
+
+const prime_table_t* prime_sieve_acquire(prime_sieve_t* sieve,
+  int64_t reader, int64_t number) {
+  assert(sieve);
+  assert(reader >= 0 && reader < sieve->reader_count);
+  prime_sieve_snapshot_t* snapshot = prime_sieve_protect(sieve, reader);
+  while (number > snapshot->table.limit
+    && snapshot->table.limit < PRIME_SIEVE_MAX_LIMIT) {
+    if (!atomic_flag_test_and_set(&sieve->is_growing)) {
+      const int error = prime_sieve_grow(sieve, number);
+      atomic_flag_clear(&sieve->is_growing);
+      if (error != EXIT_SUCCESS) {
+        // The old snapshot is used, the numbers outside of it are tested
+        // apart
+        break;
+      }
+    } else {
+      // Growing only copies the old table, the new one is sieved below
+      sched_yield();
+    }
+    snapshot = prime_sieve_protect(sieve, reader);
+  }
+  prime_sieve_snapshot_require(snapshot, number);
+  return &snapshot->table;
+}
+
+void prime_sieve_release(prime_sieve_t* sieve, int64_t reader) {
+  assert(sieve);
+  atomic_store_explicit(&sieve->hazards[reader], NULL, memory_order_release);
+}
+
+prime_sieve_snapshot_t* prime_sieve_protect(prime_sieve_t* sieve,
+  int64_t reader) {
+  prime_sieve_snapshot_t* snapshot = atomic_load(&sieve->current);
+  while (true) {
+    atomic_store(&sieve->hazards[reader], snapshot);
+    prime_sieve_snapshot_t* current = atomic_load(&sieve->current);
+    if (current == snapshot) {
+      return snapshot;
+    }
+    snapshot = current;
+  }
+}
+
+int prime_sieve_grow(prime_sieve_t* sieve, int64_t number) {
+  prime_sieve_snapshot_t* old = atomic_load(&sieve->current);
+  // Other reader could have grown the sieve after the check of the caller
+  if (number <= old->table.limit) {
+    return EXIT_SUCCESS;
+  }
+  // Doubling the limit amortizes the copies of the old tables
+  int64_t limit = 2 * old->table.limit;
+  if (limit < number) {
+    limit = number;
+  }
+  if (limit > PRIME_SIEVE_MAX_LIMIT) {
+    limit = PRIME_SIEVE_MAX_LIMIT;
+  }
+  prime_sieve_snapshot_t* snapshot = prime_sieve_snapshot_create(limit);
+  if (snapshot == NULL) {
+    return EXIT_FAILURE;
+  }
+
+  // The last segment of the old table is sieved again, because its numbers
+  // after the old limit were cleared
+  int64_t copied_count = atomic_load_explicit(&old->published_count,
+    memory_order_acquire);
+  if (copied_count > old->segment_count - 1) {
+    copied_count = old->segment_count - 1;
+  }
+  memcpy(snapshot->table.words, old->table.words, (size_t)copied_count
+    * PRIME_SIEVE_SEGMENT_WORDS * sizeof(uint64_t));
+  for (int64_t segment = 0; segment < copied_count; ++segment) {
+    atomic_init(&snapshot->is_sieved[segment], true);
+  }
+  atomic_init(&snapshot->next_segment, copied_count);
+  atomic_init(&snapshot->published_count, copied_count);
+
+  // The readers claim the other segments as they need them
+  atomic_store(&sieve->current, snapshot);
+  old->next_retired = sieve->retired;
+  sieve->retired = old;
+  prime_sieve_reclaim(sieve);
+  return EXIT_SUCCESS;
+}
+
+void prime_sieve_reclaim(prime_sieve_t* sieve) {
+  prime_sieve_snapshot_t** link = &sieve->retired;
+  while (*link) {
+    prime_sieve_snapshot_t* snapshot = *link;
+    bool is_used = false;
+    for (int64_t reader = 0; reader < sieve->reader_count && !is_used;
+      ++reader) {
+      is_used = atomic_load(&sieve->hazards[reader]) == snapshot;
+    }
+    if (is_used) {
+      link = &snapshot->next_retired;
+    } else {
+      *link = snapshot->next_retired;
+      prime_sieve_snapshot_destroy(snapshot);
+    }
+  }
+}
+
+prime_sieve_snapshot_t* prime_sieve_snapshot_create(int64_t limit) {
+  prime_sieve_snapshot_t* snapshot = (prime_sieve_snapshot_t*)
+    calloc(1, sizeof(prime_sieve_snapshot_t));
+  if (snapshot == NULL) {
+    return NULL;
+  }
+  array_int64_init(&snapshot->base_primes);
+  int error = prime_table_init(&snapshot->table, limit);
+
+  if (error == EXIT_SUCCESS) {
+    snapshot->segment_count = (snapshot->table.word_count
+      + PRIME_SIEVE_SEGMENT_WORDS - 1) / PRIME_SIEVE_SEGMENT_WORDS;
+    atomic_init(&snapshot->next_segment, 0);
+    atomic_init(&snapshot->published_count, 0);
+    atomic_flag_clear(&snapshot->is_publishing);
+    snapshot->is_sieved = (atomic_bool*) calloc(
+      (size_t)snapshot->segment_count, sizeof(atomic_bool));
+    if (snapshot->is_sieved == NULL) {
+      error = EXIT_FAILURE;
+    }
+  }
+  if (error == EXIT_SUCCESS) {
+    for (int64_t segment = 0; segment < snapshot->segment_count; ++segment) {
+      atomic_init(&snapshot->is_sieved[segment], false);
+    }
+    error = prime_sieve_find_base_primes(&snapshot->table,
+      &snapshot->base_primes);
+  }
+
+  if (error != EXIT_SUCCESS) {
+    prime_sieve_snapshot_destroy(snapshot);
+    snapshot = NULL;
+  }
+  return snapshot;
+}
+
+void prime_sieve_snapshot_destroy(prime_sieve_snapshot_t* snapshot) {
+  if (snapshot) {
+    prime_table_destroy(&snapshot->table);
+    array_int64_destroy(&snapshot->base_primes);
+    free(snapshot->is_sieved);
+    free(snapshot);
+  }
+}
+
+bool prime_sieve_snapshot_sieve_next(prime_sieve_snapshot_t* snapshot) {
+  const int64_t segment = atomic_fetch_add(&snapshot->next_segment, 1);
+  if (segment >= snapshot->segment_count) {
+    return false;
+  }
+
+  prime_table_t* table = &snapshot->table;
+  const int64_t first_word = segment * PRIME_SIEVE_SEGMENT_WORDS;
+  int64_t last_word = first_word + PRIME_SIEVE_SEGMENT_WORDS;
+  if (last_word > table->word_count) {
+    last_word = table->word_count;
+  }
+  prime_sieve_sieve_segment(table, &snapshot->base_primes, first_word,
+    last_word);
+  if (last_word == table->word_count) {
+    prime_sieve_clear_tail(table);
+  }
+
+  atomic_store(&snapshot->is_sieved[segment], true);
+  prime_sieve_snapshot_publish(snapshot);
+  return true;
+}
+
+void prime_sieve_snapshot_require(prime_sieve_snapshot_t* snapshot,
+  int64_t number) {
+  const int64_t segment_numbers = 2 * PRIME_TABLE_WORD_BITS
+    * PRIME_SIEVE_SEGMENT_WORDS;
+  // Segments needed to cover the number
+  int64_t needed_count = number / segment_numbers + 1;
+  if (needed_count > snapshot->segment_count) {
+    needed_count = snapshot->segment_count;
+  }
+
+  while (atomic_load_explicit(&snapshot->published_count,
+    memory_order_acquire) < needed_count) {
+    if (!prime_sieve_snapshot_sieve_next(snapshot)) {
+      // Other threads are sieving the segments that are missing
+      sched_yield();
+    }
+  }
+}
+
+void prime_sieve_snapshot_publish(prime_sieve_snapshot_t* snapshot) {
+  while (!atomic_flag_test_and_set(&snapshot->is_publishing)) {
+    int64_t published = atomic_load_explicit(&snapshot->published_count,
+      memory_order_relaxed);
+    while (published < snapshot->segment_count
+      && atomic_load(&snapshot->is_sieved[published])) {
+      atomic_store_explicit(&snapshot->published_count, ++published,
+        memory_order_release);
+    }
+    atomic_flag_clear(&snapshot->is_publishing);
+    // Other thread could have sieved the next segment while the flag was set,
+    // and left without publishing it
+    if (published == snapshot->segment_count
+      || !atomic_load(&snapshot->is_sieved[published])) {
+      break;
+    }
+  }
+}
+
+int prime_sieve_find_base_primes(const prime_table_t* table,
+  array_int64_t* base_primes) {
+  int error = EXIT_SUCCESS;
+  const int64_t base_limit = prime_table_sqrt(table->limit);
+  uint8_t* is_composite = (uint8_t*) calloc((size_t)base_limit + 1,
+    sizeof(uint8_t));
+  if (is_composite) {
+    for (int64_t number = 2; number <= base_limit && !error; ++number) {
+      if (!is_composite[number]) {
+        error = array_int64_append(base_primes, number);
+        for (int64_t multiple = number * number; multiple <= base_limit;
+          multiple += number) {
+          is_composite[multiple] = 1;
+        }
+      }
+    }
+    free(is_composite);
+  } else {
+    error = EXIT_FAILURE;
+  }
+  return error;
+}
+
+void prime_sieve_sieve_segment(prime_table_t* table,
+  array_int64_t* base_primes, int64_t first_word, int64_t last_word) {
+  uint64_t* words = table->words;
+  memset(words + first_word, 0xFF,
+    (size_t)(last_word - first_word) * sizeof(uint64_t));
+  // Numbers covered by the segment
+  const int64_t start = first_word * 2 * PRIME_TABLE_WORD_BITS;
+  const int64_t finish = last_word * 2 * PRIME_TABLE_WORD_BITS;
+
+  // Base prime 2 is skipped, even numbers are not stored
+  for (int64_t index = 1; index < array_int64_getCount(base_primes);
+    ++index) {
+    const int64_t prime = array_int64_getElement(base_primes, index);
+    if (prime * prime >= finish) {
+      break;
+    }
+    // First odd multiple of prime inside the segment that is not prime itself
+    int64_t multiple = (start + prime - 1) / prime * prime;
+    if (multiple < prime * prime) {
+      multiple = prime * prime;
+    }
+    if ((multiple & 1) == 0) {
+      multiple += prime;
+    }
+    for (int64_t bit = multiple >> 1; bit < finish >> 1; bit += prime) {
+      words[bit / PRIME_TABLE_WORD_BITS] &=
+        ~(UINT64_C(1) << (bit % PRIME_TABLE_WORD_BITS));
+    }
+  }
+  // 1 is not crossed out by any prime
+  if (first_word == 0) {
+    words[0] &= ~UINT64_C(1);
+  }
+}
+
+void prime_sieve_clear_tail(prime_table_t* table) {
+  // Bit of the biggest odd number that is not bigger than the limit
+  const int64_t last_bit = (table->limit - 1) / 2;
+  const int64_t last_word = last_bit / PRIME_TABLE_WORD_BITS;
+  const int64_t used_bits = last_bit % PRIME_TABLE_WORD_BITS + 1;
+  if (used_bits < PRIME_TABLE_WORD_BITS) {
+    table->words[last_word] &= (UINT64_C(1) << used_bits) - 1;
+  }
+  for (int64_t word = last_word + 1; word < table->word_count; ++word) {
+    table->words[word] = 0;
+  }
+}
@@ -0,0 +1,114 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_PRIME_SIEVE_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_PRIME_SIEVE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "array_int64.h"
+#include "prime_table.h"
+
+/// Words of the table sieved at once, 256 KiB fit in the L2 cache
+#define PRIME_SIEVE_SEGMENT_WORDS (INT64_C(1) << 15)
+/// Biggest number that is stored in the sieve, bigger ones are tested apart
+#define PRIME_SIEVE_MAX_LIMIT (INT64_C(1) << 32)
+
+/**
+ * @brief one version of the table of the sieve.
+ * @details the table is divided in segments that threads claim in ascending
+ * order. A segment is published when it and the segments before it are
+ * sieved, and the numbers covered by the published
+ * prefix of segments can be looked up while the remaining segments are still
+ * being sieved.
+ */
+typedef struct prime_sieve_snapshot {
+  prime_table_t table;
+  array_int64_t base_primes;
+  int64_t segment_count;
+  /// Next segment that has not been claimed by any thread
+  atomic_int_fast64_t next_segment;
+  /// Amount of segments at the start of the table that are published
+  atomic_int_fast64_t published_count;
+  /// Segments that are sieved, they can be ahead of the published prefix
+  atomic_bool* is_sieved;
+  /// Set while a thread publishes the sieved segments
+  atomic_flag is_publishing;
+  /// Next snapshot in the list of replaced snapshots
+  struct prime_sieve_snapshot* next_retired;
+} prime_sieve_snapshot_t;
+
+/**
+ * @brief sieve of Eratosthenes that grows when bigger numbers arrive.
+ * @details readers look primes up in the current snapshot without locks.
+ * When a number is bigger than the limit of the snapshot one reader creates
+ * a bigger snapshot with the published segments of the old one and
+ * publishes it by swapping the current pointer, and the readers sieve the
+ * rest of the new snapshot together. Every reader announces the snapshot
+ * it uses in its hazard slot, so replaced snapshots are freed only when no
+ * reader uses them.
+ */
+typedef struct prime_sieve {
+  _Atomic(prime_sieve_snapshot_t*) current;
+  /// Set while a reader creates a bigger snapshot
+  atomic_flag is_growing;
+  int64_t reader_count;
+  _Atomic(prime_sieve_snapshot_t*)* hazards;
+  /// Replaced snapshots, only accessed by the reader that grows the sieve
+  prime_sieve_snapshot_t* retired;
+} prime_sieve_t;
+
+/**
+ * @brief prepares a sieve of Eratosthenes from 0 to limit.
+ * @details finds the primes up to the square root of limit, but does not
+ * sieve the segments of the first snapshot. The limit is truncated to
+ * PRIME_SIEVE_MAX_LIMIT.
+ * @param sieve pointer to the sieve to be initialized.
+ * @param limit biggest number that is expected to be queried.
+ * @param reader_count amount of threads that will acquire the table.
+ * @return an integer to check errors.
+ */
+int prime_sieve_init(prime_sieve_t* sieve, int64_t limit,
+  int64_t reader_count);
+
+/**
+ * @brief destroys the prime_sieve struct.
+ * @details frees the current snapshot and the replaced ones, no reader can
+ * be using the sieve.
+ * @param sieve pointer to the sieve to be destroyed.
+ */
+void prime_sieve_destroy(prime_sieve_t* sieve);
+
+/**
+ * @brief sieves every segment of the current snapshot.
+ * @details used when only one thread builds the sieve.
+ * @param sieve pointer to the sieve.
+ */
+void prime_sieve_build(prime_sieve_t* sieve);
+
+/**
+ * @brief returns a table that covers a number.
+ * @details if the number is bigger than the current snapshot, the calling
+ * reader creates a bigger snapshot, or waits while other reader creates it.
+ * If it can not be allocated the current snapshot is used and the numbers
+ * after its limit are tested by prime_table_is_prime() without the table.
+ * While the segments that cover the number are not published the reader
+ * helps to sieve the unclaimed ones. The table can be used until
+ * prime_sieve_release().
+ * @param sieve pointer to the sieve.
+ * @param reader number of the calling reader, from 0 to reader_count - 1.
+ * @param number biggest number that will be looked up in the table.
+ * @return the table.
+ */
+const prime_table_t* prime_sieve_acquire(prime_sieve_t* sieve,
+  int64_t reader, int64_t number);
+
+/**
+ * @brief stops using the table returned by prime_sieve_acquire().
+ * @param sieve pointer to the sieve.
+ * @param reader number of the calling reader.
+ */
+void prime_sieve_release(prime_sieve_t* sieve, int64_t reader);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_PRIME_SIEVE_H
@@ -0,0 +1,73 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "miller_rabin.h"
+#include "prime_table.h"
+
+int prime_table_init(prime_table_t* table, int64_t limit) {
+  assert(table);
+  assert(limit >= 0);
+  table->limit = limit;
+  table->word_count = limit / (2 * PRIME_TABLE_WORD_BITS) + 1;
+  table->words = (uint64_t*) calloc((size_t)table->word_count,
+    sizeof(uint64_t));
+  if (table->words == NULL) {
+    prime_table_destroy(table);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+void prime_table_destroy(prime_table_t* table) {
+  assert(table);
+  free(table->words);
+  table->words = NULL;
+  table->word_count = 0;
+  table->limit = 0;
+}
+
+int64_t prime_table_sqrt(int64_t number) {
+  int64_t root = (int64_t)sqrt((double)number);
+  while (root > 0 && root > number / root) {
+    --root;
+  }
+  while ((root + 1) <= number / (root + 1)) {
+    ++root;
+  }
+  return root;
+}
+
+bool prime_table_is_prime_outside(int64_t number) {
+  return number >= 2 && miller_rabin_is_prime((uint64_t)number);
+}
+
+int64_t prime_table_next_prime(const prime_table_t* table, int64_t number) {
+  assert(table);
+  if (number < 2) {
+    return 2;
+  }
+  // First odd number bigger than number
+  int64_t candidate = (number + 1) | 1;
+  if (candidate <= table->limit) {
+    const int64_t bit = candidate >> 1;
+    int64_t word_index = bit / PRIME_TABLE_WORD_BITS;
+    // Ignore the numbers before the candidate in its word
+    uint64_t word = table->words[word_index]
+      & (~UINT64_C(0) << (bit % PRIME_TABLE_WORD_BITS));
+    while (word == 0 && ++word_index < table->word_count) {
+      word = table->words[word_index];
+    }
+    if (word) {
+      return 2 * (word_index * PRIME_TABLE_WORD_BITS
+        + __builtin_ctzll(word)) + 1;
+    }
+    candidate = (table->limit + 1) | 1;
+  }
+  while (!prime_table_is_prime_outside(candidate)) {
+    candidate += 2;
+  }
+  return candidate;
+}
@@ -0,0 +1,147 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_PRIME_TABLE_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_PRIME_TABLE_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Amount of odd numbers stored in every word of the table
+#define PRIME_TABLE_WORD_BITS 64
+
+/**
+ * @brief bit-packed table of primes that only stores odd numbers.
+ * @details bit k of the table is set if 2k+1 is prime, so every word covers
+ * 128 consecutive numbers and the table needs limit/16 bytes. The primes
+ * are iterated by walking the set bits of the words, see
+ * prime_table_get_word(), so no list of primes is stored.
+ */
+typedef struct prime_table {
+  int64_t limit;
+  int64_t word_count;
+  uint64_t* words;
+} prime_table_t;
+
+/**
+ * @brief initialize the prime_table struct.
+ * @details allocates the words for the numbers from 0 to limit, every number
+ * is marked as composite until the table is sieved.
+ * @param table pointer to the table to be initialized.
+ * @param limit biggest number stored in the table.
+ * @return an integer to check errors.
+ */
+int prime_table_init(prime_table_t* table, int64_t limit);
+
+/**
+ * @brief destroys the prime_table struct.
+ * @details frees the words of the table.
+ * @param table pointer to the table to be destroyed.
+ */
+void prime_table_destroy(prime_table_t* table);
+
+/**
+ * @brief returns the bit of the smallest odd prime not smaller than a number.
+ * @param first the number.
+ * @return the bit, bit k is the odd number 2k+1.
+ */
+static inline int64_t prime_table_first_bit(int64_t first) {
+  return (first > 3 ? first : 3) >> 1;
+}
+
+/**
+ * @brief returns the bit of the biggest odd number not bigger than a number.
+ * @param last the number.
+ * @return the bit, 0 (the number 1, which is not prime) if there is none.
+ */
+static inline int64_t prime_table_last_bit(int64_t last) {
+  return last > 2 ? (last - 1) >> 1 : 0;
+}
+
+/**
+ * @brief returns a word of the table with only the bits of a range.
+ * @details the primes of a range are iterated by walking the set bits of
+ * its words, from first_bit / PRIME_TABLE_WORD_BITS to
+ * last_bit / PRIME_TABLE_WORD_BITS. The composite numbers are skipped a
+ * word at a time, and the words of the range must be sieved.
+ * @param table pointer to the table.
+ * @param word_index index of the word.
+ * @param first_bit bit of the smallest number of the range.
+ * @param last_bit bit of the biggest number of the range.
+ * @return the word.
+ */
+static inline uint64_t prime_table_get_word(const prime_table_t* table,
+  int64_t word_index, int64_t first_bit, int64_t last_bit) {
+  uint64_t word = table->words[word_index];
+  const int64_t word_start = word_index * PRIME_TABLE_WORD_BITS;
+  if (word_start < first_bit) {
+    word &= ~UINT64_C(0) << (first_bit - word_start);
+  }
+  if (last_bit - word_start < PRIME_TABLE_WORD_BITS - 1) {
+    word &= ~UINT64_C(0) >> (PRIME_TABLE_WORD_BITS - 1
+      - (last_bit - word_start));
+  }
+  return word;
+}
+
+/**
+ * @brief returns the integer square root of a number.
+ * @details corrects the floating point square root, which is not exact for
+ * big numbers.
+ * @param number the number.
+ * @return the biggest integer whose square is not bigger than number.
+ */
+int64_t prime_table_sqrt(int64_t number);
+
+/**
+ * @brief returns if a number outside of a table is a prime number.
+ * @details used by prime_table_is_prime() for numbers bigger than the limit,
+ * they are tested with the deterministic Miller-Rabin test.
+ * @param number the number.
+ * @return true if the number is a prime number.
+ */
+bool prime_table_is_prime_outside(int64_t number);
+
+/**
+ * @brief returns the smallest prime number bigger than a number.
+ * @details scans the words of the table skipping the composite numbers,
+ * the search continues outside of the table if it is needed.
+ * @param table pointer to the table.
+ * @param number the number.
+ * @return the smallest prime number bigger than number.
+ */
+int64_t prime_table_next_prime(const prime_table_t* table, int64_t number);
+
+/**
+ * @brief returns if a number is a prime number.
+ * @details looks the bit of the number up, 2 is the only even prime.
+ * @param table pointer to the table.
+ * @param number the number.
+ * @return true if the number is a prime number.
+ */
+static inline bool prime_table_is_prime(const prime_table_t* table,
+  int64_t number) {
+  if (number > table->limit) {
+    return prime_table_is_prime_outside(number);
+  }
+  if (number < 0 || (number & 1) == 0) {
+    return number == 2;
+  }
+  return (table->words[number >> 7] >> ((number >> 1) & 63)) & 1;
+}
+
+/**
+ * @brief returns if an odd number of the table is a prime number.
+ * @details prime_table_is_prime() without the checks, for the inner loops
+ * whose numbers are known to be odd and not bigger than the limit.
+ * @param table pointer to the table.
+ * @param number odd number, not bigger than the limit of the table.
+ * @return true if the number is a prime number.
+ */
+static inline bool prime_table_is_odd_prime(const prime_table_t* table,
+  int64_t number) {
+  assert((number & 1) == 1 && number <= table->limit);
+  return (table->words[number >> 7] >> ((number >> 1) & 63)) & 1;
+}
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_PRIME_TABLE_H
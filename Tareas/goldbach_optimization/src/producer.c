@@ -3,27 +3,194 @@
 
 #include "producer.h"
 
+/**
+ * @brief grows the pair table when the numbers it does not cover pay for it.
+ * @details adds the cost of counting a positive number without the table.
+ * When the costs added since the table grew exceed the cost of filling the
+ * new chunks of a table half as big again, and as big as the biggest of those
+ * numbers, waits until every number appended to the stream is printed, so no
+ * consumer uses the table, and grows it. The consumers fill the new chunks
+ * when they need them. The numbers that were appended without waiting for
+ * the table are counted one by one, but their costs still count, so the
+ * stream spends at most about twice the cost of the best table.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param number number that was read, not appended to the stream yet.
+ * @param is_waiting if the numbers read before wait for the table.
+ * @param unpaid_cost cost of the numbers counted without the table since it
+ * grew, updated.
+ * @param biggest biggest of those numbers, updated.
+ * @return true if the numbers read wait for the table.
+ */
+bool produce_pair_table(goldbach_pthread_t* goldbach_pthread, int64_t number,
+  bool is_waiting, double* unpaid_cost, int64_t* biggest);
+
+/**
+ * @brief appends numbers to the stream and enqueues their units.
+ * @details waits while the window of the reorder buffer is full before every
+ * number.
+ * @param goldbach_pthread struct that contains the shared data of the threads.
+ * @param numbers the numbers in the order of the input.
+ * @param count amount of numbers.
+ * @return an integer to check errors.
+ */
+int produce_stream_numbers(goldbach_pthread_t* goldbach_pthread,
+  const int64_t* numbers, int64_t count);
+
 void* produce(void* data) {
   private_data_t* private_data = (private_data_t*)data;
   goldbach_pthread_t* goldbach_pthread = private_data->goldbach_pthread;
 
   while (true) {
     sem_wait(&goldbach_pthread->can_access_next_unit);
-    if (goldbach_pthread->next_unit > goldbach_pthread->unit_count) {
+    if (goldbach_pthread->next_unit >= goldbach_pthread->unit_count) {
       sem_post(&goldbach_pthread->can_access_next_unit);
       break;
     }
-    int64_t my_unit = goldbach_pthread->next_unit++;
+    const int64_t my_unit = goldbach_pthread->next_unit;
+    int64_t count = goldbach_claim_size(&goldbach_pthread->claim,
+      goldbach_pthread->unit_count - my_unit,
+      goldbach_pthread->consumer_count);
+    // The reorder buffer must hold every number of the batch, or the writer
+    // would wait for a number of the next window that is not enqueued
+    const int64_t window_end = goldbach_pthread_get_window_end(
+      goldbach_pthread, my_unit);
+    if (count > window_end - my_unit) {
+      count = window_end - my_unit;
+    }
+    goldbach_pthread->next_unit += count;
     sem_post(&goldbach_pthread->can_access_next_unit);
 
-    // Produce
+    // Produce the units at the next positions of the schedule in one slot
     goldbach_number_t goldbach_number;
-    goldbach_number.number = array_int64_getElement(goldbach_pthread->numbers,
-       my_unit);
-    goldbach_number.index = my_unit;
+    int64_t last_index = 0;
+    for (int64_t position = my_unit; position < my_unit + count; ++position) {
+      goldbach_pthread_get_unit(goldbach_pthread, position, &goldbach_number);
+      if (goldbach_number.index > last_index) {
+        last_index = goldbach_number.index;
+      }
+    }
+    goldbach_reorder_buffer_reserve(goldbach_pthread->reorder_buffer,
+      last_index);
+    goldbach_pthread_get_unit(goldbach_pthread, my_unit, &goldbach_number);
+    goldbach_number.position = my_unit;
+    goldbach_number.batch_count = count - 1;
     goldbach_number_queue_enqueue(&goldbach_pthread->queue, goldbach_number);
-    sem_post(&goldbach_pthread->can_consume);
   }
 
   return NULL;
 }
+
+void* produce_stream(void* data) {
+  private_data_t* private_data = (private_data_t*)data;
+  goldbach_pthread_t* goldbach_pthread = private_data->goldbach_pthread;
+  goldbach_stream_t* stream = goldbach_pthread->stream;
+  const int64_t capacity = goldbach_pthread->reorder_buffer->capacity;
+  // Numbers read that wait until the pair table is worth growing for them
+  int64_t* numbers = (int64_t*) malloc((size_t)capacity * sizeof(int64_t));
+  int64_t count = 0;
+  bool is_waiting = false;
+  double unpaid_cost = 0.0;
+  int64_t biggest = 0;
+  int64_t number = 0;
+  bool is_reading = true;
+  if (numbers == NULL) {
+    fprintf(stderr, "error: could not allocate the stream\n");
+    atomic_store(&stream->has_failed, true);
+    is_reading = false;
+  }
+
+  while (is_reading) {
+    is_reading = scanf("%" SCNd64, &number) == 1;
+    if (is_reading && number == INT64_MIN) {
+      fprintf(stderr, "error: the magnitude of %" PRId64 " does not fit in 64 "
+        "bits\n", number);
+      atomic_store(&stream->has_failed, true);
+      is_reading = false;
+    }
+    if (is_reading) {
+      numbers[count++] = number;
+      if (goldbach_pthread->options.kernel == GOLDBACH_KERNEL_LIST) {
+        is_waiting = produce_pair_table(goldbach_pthread, number, is_waiting,
+          &unpaid_cost, &biggest);
+      }
+    }
+    // The numbers after a positive one that the table does not cover wait
+    // with it, until the table grows or a window of numbers is read
+    if (!is_waiting || !is_reading || count == capacity) {
+      if (produce_stream_numbers(goldbach_pthread, numbers, count)
+        != EXIT_SUCCESS) {
+        break;
+      }
+      count = 0;
+      is_waiting = false;
+    }
+  }
+
+  free(numbers);
+  goldbach_reorder_buffer_close(goldbach_pthread->reorder_buffer,
+    stream->count);
+  return NULL;
+}
+
+int produce_stream_numbers(goldbach_pthread_t* goldbach_pthread,
+  const int64_t* numbers, int64_t count) {
+  goldbach_stream_t* stream = goldbach_pthread->stream;
+  for (int64_t position = 0; position < count; ++position) {
+    const int64_t number = numbers[position];
+    // Wait until the writer frees the results of the oldest numbers
+    goldbach_reorder_buffer_reserve(goldbach_pthread->reorder_buffer,
+      stream->count);
+    // Counting from the table takes much less than a part
+    const int64_t table_limit = goldbach_pthread->pair_table.limit;
+    int64_t part_count = 1;
+    if (number < 0 || number > table_limit) {
+      part_count = goldbach_split_choose_part_count(goldbach_cost_estimate(
+        number, table_limit, goldbach_pthread->options.kernel),
+        goldbach_pthread->consumer_count);
+    }
+    const int64_t index = goldbach_stream_append(stream, number, part_count);
+    if (index < 0) {
+      fprintf(stderr, "error: could not allocate the stream\n");
+      return EXIT_FAILURE;
+    }
+    for (int64_t part = 0; part < part_count; ++part) {
+      goldbach_number_t goldbach_number = {number, index, 0, 0, 0, 0};
+      goldbach_split_range(llabs(number), part, part_count,
+        &goldbach_number.start, &goldbach_number.finish);
+      goldbach_number_queue_enqueue(&goldbach_pthread->queue, goldbach_number);
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+bool produce_pair_table(goldbach_pthread_t* goldbach_pthread, int64_t number,
+  bool is_waiting, double* unpaid_cost, int64_t* biggest) {
+  goldbach_pair_table_t* pair_table = &goldbach_pthread->pair_table;
+  if (number <= 5 || number <= pair_table->limit
+    || number > GOLDBACH_PAIR_TABLE_MAX_LIMIT) {
+    return is_waiting;
+  }
+  *unpaid_cost += goldbach_pair_table_estimate_direct(number);
+  if (number > *biggest) {
+    *biggest = number;
+  }
+
+  int64_t limit = pair_table->limit + pair_table->limit / 2;
+  if (limit < *biggest) {
+    limit = *biggest;
+  }
+  if (limit > GOLDBACH_PAIR_TABLE_MAX_LIMIT) {
+    limit = GOLDBACH_PAIR_TABLE_MAX_LIMIT;
+  }
+  if (*unpaid_cost > goldbach_pair_table_estimate_fill(limit)
+    - goldbach_pair_table_estimate_fill(pair_table->limit)) {
+    goldbach_reorder_buffer_wait_flushed(goldbach_pthread->reorder_buffer,
+      goldbach_pthread->stream->count);
+    // Without the new chunks the count kernels answer the bigger numbers
+    goldbach_pair_table_grow(pair_table, limit);
+    *unpaid_cost = 0.0;
+    *biggest = 0;
+    return false;
+  }
+  return true;
+}
@@ -7,6 +7,29 @@
 #include <stdio.h>
 #include "common.h"
 
+/**
+ * @brief enqueues the units of the batch in the order of the schedule.
+ * @details every slot of the queue carries a batch of units at consecutive
+ * positions of one window, as many as the claim chooses. Waits while the
+ * last number of a batch is out of the window of the reorder buffer.
+ * @param data private_data of the producer.
+ * @return null.
+ */
 void* produce(void* data);
 
+/**
+ * @brief reads the numbers of stdin and enqueues their units at once.
+ * @details every number is appended to the stream and split in parts by its
+ * estimated cost, so the consumers start with the first number while the
+ * rest of the input is read. A positive number that the pair table does not
+ * cover waits, with the numbers after it, until their costs pay for growing
+ * the table or a window of numbers is read, so the table grows only when
+ * counting them one by one would cost more. Waits while the window of the
+ * reorder buffer is full, and closes it at the end of the input or when an
+ * entry can not be allocated.
+ * @param data private_data of the reader.
+ * @return null.
+ */
+void* produce_stream(void* data);
+
 #endif  // PRODUCER_H
@@ -0,0 +1,127 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "thread_pool.h"
+
+/**
+ * @brief runs the submitted tasks until the pool stops.
+ * @param data pointer to the pool.
+ * @return null.
+ */
+void* thread_pool_work(void* data);
+
+int thread_pool_init(thread_pool_t* pool, int64_t thread_count) {
+  assert(pool);
+  assert(thread_count > 0);
+  pool->thread_count = 0;
+  pool->first_task = NULL;
+  pool->last_task = NULL;
+  pool->pending_count = 0;
+  pool->is_stopping = false;
+  pthread_mutex_init(&pool->can_access_tasks, NULL);
+  pthread_cond_init(&pool->has_tasks, NULL);
+  pthread_cond_init(&pool->is_done, NULL);
+  pool->threads = (pthread_t*) calloc((size_t)thread_count, sizeof(pthread_t));
+  if (pool->threads == NULL) {
+    thread_pool_destroy(pool);
+    return EXIT_FAILURE;
+  }
+
+  for (int64_t index = 0; index < thread_count; ++index) {
+    if (pthread_create(&pool->threads[index], /*attr*/ NULL, thread_pool_work,
+      pool) != EXIT_SUCCESS) {
+      fprintf(stderr, "error: could not create thread %" PRId64 "\n", index);
+      thread_pool_destroy(pool);
+      return EXIT_FAILURE;
+    }
+    ++pool->thread_count;
+  }
+  return EXIT_SUCCESS;
+}
+
+void thread_pool_destroy(thread_pool_t* pool) {
+  assert(pool);
+  thread_pool_wait(pool);
+  pthread_mutex_lock(&pool->can_access_tasks);
+  pool->is_stopping = true;
+  pthread_cond_broadcast(&pool->has_tasks);
+  pthread_mutex_unlock(&pool->can_access_tasks);
+
+  for (int64_t index = 0; index < pool->thread_count; ++index) {
+    pthread_join(pool->threads[index], /*value_ptr*/ NULL);
+  }
+  free(pool->threads);
+  pool->threads = NULL;
+  pool->thread_count = 0;
+  pthread_cond_destroy(&pool->is_done);
+  pthread_cond_destroy(&pool->has_tasks);
+  pthread_mutex_destroy(&pool->can_access_tasks);
+}
+
+int thread_pool_submit(thread_pool_t* pool, void* (*subroutine)(void* data),
+  void* data) {
+  assert(pool);
+  assert(subroutine);
+  thread_pool_task_t* task = (thread_pool_task_t*)
+    malloc(sizeof(thread_pool_task_t));
+  if (task == NULL) {
+    return EXIT_FAILURE;
+  }
+  task->subroutine = subroutine;
+  task->data = data;
+  task->next = NULL;
+
+  pthread_mutex_lock(&pool->can_access_tasks);
+  if (pool->last_task) {
+    pool->last_task->next = task;
+  } else {
+    pool->first_task = task;
+  }
+  pool->last_task = task;
+  ++pool->pending_count;
+  pthread_cond_signal(&pool->has_tasks);
+  pthread_mutex_unlock(&pool->can_access_tasks);
+  return EXIT_SUCCESS;
+}
+
+void thread_pool_wait(thread_pool_t* pool) {
+  assert(pool);
+  pthread_mutex_lock(&pool->can_access_tasks);
+  while (pool->pending_count > 0) {
+    pthread_cond_wait(&pool->is_done, &pool->can_access_tasks);
+  }
+  pthread_mutex_unlock(&pool->can_access_tasks);
+}
+
+void* thread_pool_work(void* data) {
+  thread_pool_t* pool = (thread_pool_t*)data;
+  pthread_mutex_lock(&pool->can_access_tasks);
+  while (true) {
+    while (pool->first_task == NULL && !pool->is_stopping) {
+      pthread_cond_wait(&pool->has_tasks, &pool->can_access_tasks);
+    }
+    if (pool->first_task == NULL) {
+      break;
+    }
+    thread_pool_task_t* task = pool->first_task;
+    pool->first_task = task->next;
+    if (pool->first_task == NULL) {
+      pool->last_task = NULL;
+    }
+    pthread_mutex_unlock(&pool->can_access_tasks);
+
+    task->subroutine(task->data);
+    free(task);
+
+    pthread_mutex_lock(&pool->can_access_tasks);
+    if (--pool->pending_count == 0) {
+      pthread_cond_broadcast(&pool->is_done);
+    }
+  }
+  pthread_mutex_unlock(&pool->can_access_tasks);
+  return NULL;
+}
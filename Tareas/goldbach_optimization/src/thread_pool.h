@@ -0,0 +1,75 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_THREAD_POOL_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_THREAD_POOL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief a subroutine submitted to the pool and the data it receives.
+ */
+typedef struct thread_pool_task {
+  void* (*subroutine)(void* data);
+  void* data;
+  struct thread_pool_task* next;
+} thread_pool_task_t;
+
+/**
+ * @brief threads that are created once and run batches of tasks.
+ * @details every idle worker takes the oldest submitted task. The tasks of a
+ * batch run at the same time while the batch has at most thread_count tasks,
+ * so tasks that wait for each other, like the consumers of a queue, can be
+ * submitted together. Between batches the workers sleep on a condition
+ * variable.
+ */
+typedef struct thread_pool {
+  int64_t thread_count;
+  pthread_t* threads;
+  pthread_mutex_t can_access_tasks;
+  /// Signaled when a task is submitted or the pool is stopping
+  pthread_cond_t has_tasks;
+  /// Signaled when every submitted task is finished
+  pthread_cond_t is_done;
+  /// Submitted tasks that no worker has taken, oldest first
+  thread_pool_task_t* first_task;
+  thread_pool_task_t* last_task;
+  /// Submitted tasks that are not finished, including the running ones
+  int64_t pending_count;
+  bool is_stopping;
+} thread_pool_t;
+
+/**
+ * @brief initialize the thread_pool struct and creates its workers.
+ * @param pool pointer to the pool to be initialized.
+ * @param thread_count amount of workers.
+ * @return an integer to check errors.
+ */
+int thread_pool_init(thread_pool_t* pool, int64_t thread_count);
+
+/**
+ * @brief destroys the thread_pool struct.
+ * @details waits for the submitted tasks, stops the workers and joins them.
+ * @param pool pointer to the pool to be destroyed.
+ */
+void thread_pool_destroy(thread_pool_t* pool);
+
+/**
+ * @brief adds a task for the next idle worker.
+ * @details this subroutine is thread-safe.
+ * @param pool pointer to the pool.
+ * @param subroutine the subroutine that the worker runs.
+ * @param data the argument of the subroutine.
+ * @return an integer to check errors.
+ */
+int thread_pool_submit(thread_pool_t* pool, void* (*subroutine)(void* data),
+  void* data);
+
+/**
+ * @brief waits until every submitted task is finished.
+ * @param pool pointer to the pool.
+ */
+void thread_pool_wait(thread_pool_t* pool);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_THREAD_POOL_H
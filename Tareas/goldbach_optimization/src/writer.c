@@ -0,0 +1,39 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#include "writer.h"
+
+void* write_results(void* data) {
+  private_data_t* private_data = (private_data_t*)data;
+  goldbach_pthread_bind(private_data);
+  goldbach_pthread_t* goldbach_pthread = private_data->goldbach_pthread;
+  goldbach_reorder_buffer_t* buffer = goldbach_pthread->reorder_buffer;
+  goldbach_output_t* output = &goldbach_pthread->output;
+
+  while (true) {
+    // Show the printed numbers before waiting for the next one
+    if (!goldbach_reorder_buffer_is_ready(buffer)) {
+      goldbach_output_flush(output);
+    }
+    const int64_t index = goldbach_reorder_buffer_next(buffer);
+    if (index < 0) {
+      break;
+    }
+    goldbach_sums_array_t* goldbach_sums = goldbach_pthread_get_sums(
+      goldbach_pthread, index);
+    // After a failed write or unit the numbers are only freed, the run
+    // reports it
+    if (!output->has_failed && !atomic_load(&goldbach_pthread->has_failed)) {
+      goldbach_sums_array_print(goldbach_sums, output);
+    }
+    if (goldbach_pthread->stream) {
+      goldbach_stream_release(goldbach_pthread->stream);
+    } else {
+      goldbach_sums_array_destroy(goldbach_sums);
+    }
+    goldbach_reorder_buffer_advance(buffer);
+  }
+  // The text of the batch is written before the batch ends
+  goldbach_output_flush(output);
+
+  return NULL;
+}
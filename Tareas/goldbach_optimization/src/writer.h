@@ -0,0 +1,24 @@
+// Copyright 2021 Gilbert Marquez Aldana <gilbert.marquez@ucr.ac.cr>
+
+#ifndef TAREAS_GOLDBACH_OPTIMIZATION_WRITER_H
+#define TAREAS_GOLDBACH_OPTIMIZATION_WRITER_H
+
+#include "common.h"
+
+/**
+ * @brief prints the numbers in the order of the input as they finish.
+ * @details takes the finished prefix of the reorder buffer, prints every
+ * number and frees its results at once, and writes the text to stdout before
+ * it waits for the next number. The sums of the numbers that finished close
+ * to the writer were already formatted by the consumers, so the writer only
+ * formats the first line of those numbers and copies the rest. If a write
+ * to stdout fails, the output is marked as failed and the rest of the
+ * numbers are freed without printing them, so the run returns an error
+ * instead of exiting with a truncated output. Ends when every number of the
+ * input is printed.
+ * @param data private_data of the writer.
+ * @return null.
+ */
+void* write_results(void* data);
+
+#endif  // TAREAS_GOLDBACH_OPTIMIZATION_WRITER_H
@@ -13,3 +13,70 @@ int block_mapping_finish(int64_t thread_number, int64_t total_numbers,
   int64_t thread_count) {
   return block_mapping_start(thread_number + 1, total_numbers, thread_count);
 }
+
+int64_t block_mapping_cyclic_start(int64_t thread_number) {
+  return thread_number;
+}
+
+int64_t block_mapping_cyclic_next(int64_t index, int64_t thread_count) {
+  return index + thread_count;
+}
+
+int64_t block_mapping_block_cyclic_start(int64_t thread_number,
+  int64_t block_size) {
+  return thread_number * block_size;
+}
+
+int64_t block_mapping_block_cyclic_next(int64_t index, int64_t block_size,
+  int64_t thread_count) {
+  ++index;
+  // Skip the blocks of the other threads at the end of a block
+  if (index % block_size == 0) {
+    index += (thread_count - 1) * block_size;
+  }
+  return index;
+}
+
+int64_t block_mapping_first(const block_mapping_t* mapping,
+  int64_t thread_number) {
+  int64_t index = 0;
+  switch (mapping->kind) {
+    case BLOCK_MAPPING_CYCLIC:
+      index = block_mapping_cyclic_start(thread_number);
+      break;
+    case BLOCK_MAPPING_BLOCK_CYCLIC:
+      index = block_mapping_block_cyclic_start(thread_number,
+        mapping->block_size);
+      break;
+    default:
+      index = block_mapping_start(thread_number, mapping->total_numbers,
+        mapping->thread_count);
+      if (index >= block_mapping_finish(thread_number,
+        mapping->total_numbers, mapping->thread_count)) {
+        index = mapping->total_numbers;
+      }
+      break;
+  }
+  return index < mapping->total_numbers ? index : mapping->total_numbers;
+}
+
+int64_t block_mapping_next(const block_mapping_t* mapping,
+  int64_t thread_number, int64_t index) {
+  switch (mapping->kind) {
+    case BLOCK_MAPPING_CYCLIC:
+      index = block_mapping_cyclic_next(index, mapping->thread_count);
+      break;
+    case BLOCK_MAPPING_BLOCK_CYCLIC:
+      index = block_mapping_block_cyclic_next(index, mapping->block_size,
+        mapping->thread_count);
+      break;
+    default:
+      ++index;
+      if (index >= block_mapping_finish(thread_number,
+        mapping->total_numbers, mapping->thread_count)) {
+        index = mapping->total_numbers;
+      }
+      break;
+  }
+  return index < mapping->total_numbers ? index : mapping->total_numbers;
+}
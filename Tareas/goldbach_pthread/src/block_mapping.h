@@ -3,8 +3,30 @@
 #ifndef TAREAS_GOLDBACH_PTHREAD_BLOCK_MAPPING_H_
 #define TAREAS_GOLDBACH_PTHREAD_BLOCK_MAPPING_H_
 
+#include <stdint.h>
 #include <stdlib.h>
 
+/// Numbers of every block of the block-cyclic mapping if none is given
+#define BLOCK_MAPPING_BLOCK_SIZE 8
+
+/// Static ways to assign the numbers to the threads
+typedef enum block_mapping_kind {
+  /// Every thread takes one contiguous block of numbers
+  BLOCK_MAPPING_BLOCK,
+  /// Thread i takes the numbers i, i + thread_count, i + 2 * thread_count...
+  BLOCK_MAPPING_CYCLIC,
+  /// Blocks of block_size numbers are dealt to the threads in turns
+  BLOCK_MAPPING_BLOCK_CYCLIC,
+} block_mapping_kind_t;
+
+typedef struct block_mapping {
+  block_mapping_kind_t kind;
+  /// Numbers of every block dealt by the block-cyclic mapping
+  int64_t block_size;
+  int64_t total_numbers;
+  int64_t thread_count;
+} block_mapping_t;
+
 /**
  * @brief returns the start index of a block mapping.
  * @details calculates and returns the start index of a block mapping.
@@ -27,4 +49,59 @@ int block_mapping_start(int64_t thread_number, int64_t total_numbers,
 int block_mapping_finish(int64_t thread_number, int64_t total_numbers,
   int64_t thread_count);
 
+/**
+ * @brief returns the first index of a cyclic mapping.
+ * @param thread_number the number of thread which index will be assigned.
+ * @return the first index of a cyclic mapping.
+ */
+int64_t block_mapping_cyclic_start(int64_t thread_number);
+
+/**
+ * @brief returns the index after an index of a cyclic mapping.
+ * @param index index assigned to the thread.
+ * @param thread_count the total number of threads.
+ * @return the next index assigned to the same thread.
+ */
+int64_t block_mapping_cyclic_next(int64_t index, int64_t thread_count);
+
+/**
+ * @brief returns the first index of a block-cyclic mapping.
+ * @param thread_number the number of thread which index will be assigned.
+ * @param block_size amount of numbers of every block.
+ * @return the first index of a block-cyclic mapping.
+ */
+int64_t block_mapping_block_cyclic_start(int64_t thread_number,
+  int64_t block_size);
+
+/**
+ * @brief returns the index after an index of a block-cyclic mapping.
+ * @details the next index of the same block, or the first index of the next
+ * block of the thread, thread_count blocks later.
+ * @param index index assigned to the thread.
+ * @param block_size amount of numbers of every block.
+ * @param thread_count the total number of threads.
+ * @return the next index assigned to the same thread.
+ */
+int64_t block_mapping_block_cyclic_next(int64_t index, int64_t block_size,
+  int64_t thread_count);
+
+/**
+ * @brief returns the first index assigned to a thread by a mapping.
+ * @param mapping the mapping.
+ * @param thread_number the number of thread which index will be assigned.
+ * @return the first index, or total_numbers if the thread has no numbers.
+ */
+int64_t block_mapping_first(const block_mapping_t* mapping,
+  int64_t thread_number);
+
+/**
+ * @brief returns the index after an index assigned to a thread by a mapping.
+ * @param mapping the mapping.
+ * @param thread_number the number of thread which index will be assigned.
+ * @param index index assigned to the thread.
+ * @return the next index, or total_numbers if it was the last one.
+ */
+int64_t block_mapping_next(const block_mapping_t* mapping,
+  int64_t thread_number, int64_t index);
+
 #endif  // TAREAS_GOLDBACH_PTHREAD_BLOCK_MAPPING_H_
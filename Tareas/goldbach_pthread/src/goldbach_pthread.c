@@ -30,6 +30,33 @@ void free_goldbach_sums_matrix(const int64_t row_count, goldbach_sums_array_t**
  */
 bool isPrime(int64_t number);
 
+/**
+ * @brief reads the mapping of the numbers to the threads.
+ * @details accepts block, cyclic, block-cyclic and block-cyclic:K.
+ * @param text the value of the --mapping argument.
+ * @param mapping where the kind and the block size are stored.
+ * @return an integer to check errors.
+ */
+int goldbach_pthread_parse_mapping(const char* text,
+  block_mapping_t* mapping);
+
+/**
+ * @brief returns the estimated operations to calculate the sums of a number.
+ * @details the even numbers check about n / 2 pairs, the odd numbers about
+ * n^2 / 12 trios.
+ * @param number the number.
+ * @return the estimated operations.
+ */
+double goldbach_pthread_estimate_work(int64_t number);
+
+/**
+ * @brief prints the work done by every thread in stderr.
+ * @param private_data the data of every thread.
+ * @param thread_count amount of threads.
+ */
+void goldbach_pthread_print_work(const private_data_t* private_data,
+  int64_t thread_count);
+
 goldbach_pthread_t* goldbach_pthread_create(array_int64_t* numbers) {
   goldbach_pthread_t* goldbach_pthread = (goldbach_pthread_t*)
     calloc(1, sizeof(goldbach_pthread_t));
@@ -45,24 +72,64 @@ int goldbach_pthread_run(goldbach_pthread_t* goldbach_pthread, int argc,
   int error = EXIT_SUCCESS;
   // Assign thread_count
   goldbach_pthread->thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+  goldbach_pthread->mapping.kind = BLOCK_MAPPING_BLOCK;
+  goldbach_pthread->mapping.block_size = BLOCK_MAPPING_BLOCK_SIZE;
   if (goldbach_pthread) {
-    if (argc == 2) {
-      if (sscanf(argv[1], "%zu", &goldbach_pthread->thread_count) != 1
-        || errno) {
+    for (int index = 1; index < argc && error == EXIT_SUCCESS; ++index) {
+      if (strncmp(argv[index], "--mapping=", 10) == 0) {
+        error = goldbach_pthread_parse_mapping(argv[index] + 10,
+          &goldbach_pthread->mapping);
+      } else if (sscanf(argv[index], "%" SCNd64,
+        &goldbach_pthread->thread_count) != 1 || errno
+        || goldbach_pthread->thread_count <= 0) {
         fprintf(stderr, "error: invalid thread count\n");
         error = 1;
       }
     }
+    // The workers are created once and calculate every batch
+    if (error == EXIT_SUCCESS && goldbach_pthread->pool.threads == NULL
+      && thread_pool_init(&goldbach_pthread->pool,
+      goldbach_pthread->thread_count) != EXIT_SUCCESS) {
+      fprintf(stderr, "Could not allocate memory for %" PRId64 " threads\n"
+        , goldbach_pthread->thread_count);
+      error = 22;
+    }
     if (error == EXIT_SUCCESS) {
       // Create goldbach sums matrix to use conditionally safety
       goldbach_pthread->goldbach_sums = create_goldbach_sums_matrix(
         goldbach_pthread->numbers);
+      // Create threads
+      error = goldbach_pthread_create_threads(goldbach_pthread);
+      // Free matrix after all calculations finished
+      free_goldbach_sums_matrix(array_int64_getCount(goldbach_pthread->numbers),
+        goldbach_pthread->goldbach_sums);
     }
-    // Create threads
-    error = goldbach_pthread_create_threads(goldbach_pthread);
-    // Free matrix after all calculations finished
-    free_goldbach_sums_matrix(array_int64_getCount(goldbach_pthread->numbers),
-      goldbach_pthread->goldbach_sums);
+  }
+  return error;
+}
+
+int goldbach_pthread_parse_mapping(const char* text,
+  block_mapping_t* mapping) {
+  assert(text);
+  assert(mapping);
+  int error = EXIT_SUCCESS;
+  if (strcmp(text, "block") == 0) {
+    mapping->kind = BLOCK_MAPPING_BLOCK;
+  } else if (strcmp(text, "cyclic") == 0) {
+    mapping->kind = BLOCK_MAPPING_CYCLIC;
+  } else if (strcmp(text, "block-cyclic") == 0) {
+    mapping->kind = BLOCK_MAPPING_BLOCK_CYCLIC;
+  } else if (strncmp(text, "block-cyclic:", 13) == 0) {
+    mapping->kind = BLOCK_MAPPING_BLOCK_CYCLIC;
+    char extra = '\0';
+    if (sscanf(text + 13, "%" SCNd64 "%c", &mapping->block_size, &extra) != 1
+      || mapping->block_size <= 0) {
+      fprintf(stderr, "error: invalid block size\n");
+      error = 3;
+    }
+  } else {
+    fprintf(stderr, "error: invalid mapping\n");
+    error = 2;
   }
   return error;
 }
@@ -71,72 +138,74 @@ int goldbach_pthread_create_threads(goldbach_pthread_t* goldbach_pthread) {
   assert(goldbach_pthread);
   int error = EXIT_SUCCESS;
   
-  // Allocate space for threads and their respective private data
-  pthread_t* threads = (pthread_t*) calloc(goldbach_pthread->thread_count
-    , sizeof(pthread_t));
+  int64_t numbers_count = array_int64_getCount(goldbach_pthread->numbers);
+  // If there are more threads than numbers, then use as many threads as
+  // numbers
+  if (numbers_count < goldbach_pthread->thread_count) {
+    goldbach_pthread->thread_count = numbers_count;
+  }
+  goldbach_pthread->mapping.total_numbers = numbers_count;
+  goldbach_pthread->mapping.thread_count = goldbach_pthread->thread_count;
+  if (goldbach_pthread->thread_count == 0) {
+    return error;
+  }
+
+  // Allocate the private data of the workers of the pool
+  thread_pool_t* pool = &goldbach_pthread->pool;
   private_data_t* private_data = (private_data_t*)
     calloc(goldbach_pthread->thread_count, sizeof(private_data_t));
 
-  if (threads && private_data) {
-    int64_t numbers_count = array_int64_getCount(goldbach_pthread->numbers);
-    int64_t thread_count = goldbach_pthread->thread_count;
-    // If there are more threads than numbers, then use as many threads as 
-    // numbers
-    if (numbers_count < thread_count) {
-      thread_count = numbers_count;
-    }
-
+  if (private_data) {
     for (int64_t index = 0; index < goldbach_pthread->thread_count; ++index) {
       private_data[index].thread_number = index;
       private_data[index].goldbach_pthread = goldbach_pthread;
-      // Get working block for every thread
-      private_data[index].start_index = block_mapping_start(
-        private_data[index].thread_number, numbers_count, thread_count);
-      private_data[index].finish_index = block_mapping_finish(
-        private_data[index].thread_number, numbers_count, thread_count);
-      // Create thread and make it work with it's respective working block
-      if (pthread_create(&threads[index], /*attr*/NULL,
-        goldbach_pthread_calculate_goldbach, &private_data[index])
-        == EXIT_SUCCESS) {
-      } else {
-          fprintf(stderr, "error: could not create thread %zu\n", index);
-          error = 21;
-          goldbach_pthread->thread_count = index;
-          break;
-        }
-    }
-    // Join of threads after finishing their work
-    for (int64_t index = 0; index < goldbach_pthread->thread_count; ++index) {
-      pthread_join(threads[index], /*value_ptr*/ NULL);
+      // Make a worker work with it's respective numbers
+      if (thread_pool_submit(pool, goldbach_pthread_calculate_goldbach,
+        &private_data[index]) != EXIT_SUCCESS) {
+        fprintf(stderr, "error: could not submit thread %" PRId64 "\n",
+          index);
+        error = 21;
+        break;
+      }
     }
-    // Printing the results
-    for (int64_t index = 0; index < array_int64_getCount(
-      goldbach_pthread->numbers); index++) {
-      goldbach_sums_array_print(goldbach_pthread->goldbach_sums[index]);
+    // Wait for the workers to finish their work, they stay for the next batch
+    thread_pool_wait(pool);
+    if (error == EXIT_SUCCESS) {
+      goldbach_pthread_print_work(private_data,
+        goldbach_pthread->thread_count);
+      // Printing the results
+      for (int64_t index = 0; index < numbers_count; index++) {
+        goldbach_sums_array_print(goldbach_pthread->goldbach_sums[index]);
+      }
     }
-    // Free memory
-    free(threads);
-    free(private_data);
   } else {
-    fprintf(stderr, "Could not allocate memory for %zu threads\n"
+    fprintf(stderr, "Could not allocate memory for %" PRId64 " threads\n"
       , goldbach_pthread->thread_count);
     error = 22;
   }
+  // Free memory
+  free(private_data);
   return error;
 }
 
 void* goldbach_pthread_calculate_goldbach(void* data) {
   assert(data);
-  const private_data_t* private_data = (private_data_t*)data;
+  private_data_t* private_data = (private_data_t*)data;
   goldbach_pthread_t* goldbach_pthread = private_data->goldbach_pthread;
-  // Calculate numbers inside the block (between start_index and finish_index)
-  for (int index = private_data->start_index; index < private_data
-    ->finish_index; index++) {
+  const block_mapping_t* mapping = &goldbach_pthread->mapping;
+  struct timespec start_time;
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+  // Calculate the numbers that the mapping assigned to this thread
+  for (int64_t index = block_mapping_first(mapping,
+    private_data->thread_number); index < mapping->total_numbers;
+    index = block_mapping_next(mapping, private_data->thread_number, index)) {
     int64_t number = array_int64_getElement(goldbach_pthread->numbers, index);
     // Change number to positive if it is negative
     if (number < 0) {
       number *= -1;
     }
+    ++private_data->number_count;
+    private_data->work += goldbach_pthread_estimate_work(number);
     // If number is smaller than 6, it doesn't have any goldbach sum
     if (number > 5) {
       if (number % 2 == 0) {
@@ -146,9 +215,35 @@ void* goldbach_pthread_calculate_goldbach(void* data) {
       }
     }
   }
+  struct timespec finish_time;
+  clock_gettime(CLOCK_MONOTONIC, &finish_time);
+  private_data->elapsed = (finish_time.tv_sec - start_time.tv_sec)
+    + (finish_time.tv_nsec - start_time.tv_nsec) * 1e-9;
   return NULL;
 }
 
+double goldbach_pthread_estimate_work(int64_t number) {
+  if (number <= 5) {
+    return 0.0;
+  }
+  return number % 2 == 0 ? number / 2.0 : (double)number * number / 12.0;
+}
+
+void goldbach_pthread_print_work(const private_data_t* private_data,
+  int64_t thread_count) {
+  double total_work = 0.0;
+  for (int64_t index = 0; index < thread_count; ++index) {
+    total_work += private_data[index].work;
+  }
+  for (int64_t index = 0; index < thread_count; ++index) {
+    fprintf(stderr, "thread %" PRId64 ": %" PRId64 " numbers, work %.3e"
+      " (%.1f%%), %.6f s\n", private_data[index].thread_number,
+      private_data[index].number_count, private_data[index].work,
+      total_work > 0.0 ? 100.0 * private_data[index].work / total_work : 0.0,
+      private_data[index].elapsed);
+  }
+}
+
 int goldbach_pthread_strong_conjecture(goldbach_pthread_t* goldbach_pthread,
   int64_t number, int64_t index_number) {
   assert(goldbach_pthread);
@@ -207,6 +302,9 @@ int goldbach_pthread_weak_conjecture(goldbach_pthread_t* goldbach_pthread,
 
 int goldbach_pthread_destroy(goldbach_pthread_t* goldbach_pthread) {
   assert(goldbach_pthread);
+  if (goldbach_pthread->pool.threads) {
+    thread_pool_destroy(&goldbach_pthread->pool);
+  }
   free(goldbach_pthread);
   return EXIT_SUCCESS;
 }
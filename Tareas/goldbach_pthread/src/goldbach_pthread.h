@@ -5,26 +5,39 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <math.h>
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include "array_int64.h"
 #include "block_mapping.h"
 #include "goldbach_sums_array.h"
+#include "thread_pool.h"
 
 // Shared_data
 typedef struct goldbach_pthread {
   int64_t thread_count;
+  /// Static mapping of the numbers to the threads
+  block_mapping_t mapping;
   array_int64_t* numbers;
   goldbach_sums_array_t** goldbach_sums;
+  /// Workers that calculate every batch, created once
+  thread_pool_t pool;
 } goldbach_pthread_t;
 
 typedef struct  {
-  int64_t start_index;
-  int64_t finish_index;
   int64_t thread_number;
+  /// Amount of numbers calculated by the thread
+  int64_t number_count;
+  /// Estimated operations of the numbers calculated by the thread
+  double work;
+  /// Seconds that the thread spent calculating
+  double elapsed;
   goldbach_pthread_t* goldbach_pthread;
 } private_data_t;
 
@@ -38,9 +51,11 @@ goldbach_pthread_t* goldbach_pthread_create(array_int64_t* numbers);
 
 /**
  * @brief prepares execution of program does the things
- * @details verifies if number of threads was given by the user, creates the 
- * matrix for conditionally safe and calls to create threads and continue the
- * execution of the program.
+ * @details verifies if number of threads and the mapping were given by the
+ * user, creates the thread pool the first time, creates the matrix for
+ * conditionally safe and calls to create threads and continue the execution
+ * of the program. The mapping is chosen with
+ * --mapping=block, --mapping=cyclic or --mapping=block-cyclic[:K].
  * @param goldbach_pthread struct that contains the shared data of the threads.
  * @param argc amount of arguments given in console.
  * @param argv arguments given in console.
@@ -87,8 +102,9 @@ int goldbach_pthread_weak_conjecture(goldbach_pthread_t* goldbach_pthread,
 
 /**
  * @brief creates the threads and puts them to do the calculations.
- * @details creates the threads, puts them to do the calculations, joins the
- * threads and prints the results.
+ * @details submits the calculations of every thread to the thread pool of
+ * goldbach_pthread, waits for them, prints the results and the work of every
+ * thread in stderr. The workers of the pool stay for the next batch.
  * @param goldbach_pthread struct that contains the shared data of the threads.
  * @return an integer to check errors.
  */